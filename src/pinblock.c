@@ -21,12 +21,137 @@
 
 #include "pinblock.h"
 
+#include <limits.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
+
+#ifndef __STDC_NO_ATOMICS__
+#include <stdatomic.h>
+#endif
 
 #include "crypto_mem.h"
 #include "crypto_rand.h"
 
+/**
+ * PIN field padding rules
+ * @remark See ISO 9564-1:2017 9.3 and 9.4.2.2.2
+ */
+enum pinblock_fill_rule_t {
+	PINBLOCK_FILL_NONE = 0, ///< Unsupported PIN block format
+	PINBLOCK_FILL_CONSTANT, ///< Padding digits have a constant value
+	PINBLOCK_FILL_NONCE, ///< Padding digits are a caller provided nonce or random
+	PINBLOCK_FILL_RANDOM_RANGE, ///< Padding digits are random within a range
+};
+
+/**
+ * PIN block format descriptor
+ *
+ * Describes PIN block formats that start with a control field and a PIN
+ * length field, followed by the PIN and padding digits. All such formats
+ * share the same decoder, driven by the descriptor of the relevant format.
+ * The ISO 9564-1:2017 PIN block formats have specialised encoders, while the
+ * shared encoder serves the remaining formats described by a descriptor and
+ * the paths that select the format at runtime.
+ *
+ * Formats without a control field, with a delimiter-terminated PIN or with
+ * the PIN length in the first digit cannot be described by a descriptor and
+ * have their own encoder and decoder.
+ */
+struct pinblock_format_desc_t {
+	uint8_t control; ///< Control field (first nibble) of PIN field
+	size_t block_size; ///< PIN block (or PIN field) size in bytes
+	enum pinblock_fill_rule_t fill_rule; ///< Padding rule
+	uint8_t fill_min; ///< Minimum padding digit value
+	uint8_t fill_max; ///< Maximum padding digit value
+	bool pan_binding; ///< Whether PIN field is XOR'd with PAN field
+};
+
+/**
+ * PIN block format descriptors, indexed by control field such that format
+ * lookup is a single table access. Unused entries have a zero block size.
+ */
+static const struct pinblock_format_desc_t pinblock_format_desc[16] = {
+	// See ISO 9564-1:2017 9.3.2
+	[PINBLOCK_ISO9564_FORMAT_0] = {
+		.control = PINBLOCK_ISO9564_FORMAT_0,
+		.block_size = PINBLOCK_SIZE,
+		.fill_rule = PINBLOCK_FILL_CONSTANT,
+		.fill_min = 0xF,
+		.fill_max = 0xF,
+		.pan_binding = true,
+	},
+
+	// See ISO 9564-1:2017 9.3.3
+	[PINBLOCK_ISO9564_FORMAT_1] = {
+		.control = PINBLOCK_ISO9564_FORMAT_1,
+		.block_size = PINBLOCK_SIZE,
+		.fill_rule = PINBLOCK_FILL_NONCE,
+		.fill_min = 0x0,
+		.fill_max = 0xF,
+		.pan_binding = false,
+	},
+
+	// See ISO 9564-1:2017 9.3.4
+	[PINBLOCK_ISO9564_FORMAT_2] = {
+		.control = PINBLOCK_ISO9564_FORMAT_2,
+		.block_size = PINBLOCK_SIZE,
+		.fill_rule = PINBLOCK_FILL_CONSTANT,
+		.fill_min = 0xF,
+		.fill_max = 0xF,
+		.pan_binding = false,
+	},
+
+	// See ISO 9564-1:2017 9.3.5
+	[PINBLOCK_ISO9564_FORMAT_3] = {
+		.control = PINBLOCK_ISO9564_FORMAT_3,
+		.block_size = PINBLOCK_SIZE,
+		.fill_rule = PINBLOCK_FILL_RANDOM_RANGE,
+		.fill_min = 0xA,
+		.fill_max = 0xF,
+		.pan_binding = true,
+	},
+
+	// See ISO 9564-1:2017 9.4.2.2.2
+	[PINBLOCK_ISO9564_FORMAT_4] = {
+		.control = PINBLOCK_ISO9564_FORMAT_4,
+		.block_size = PINBLOCK128_SIZE,
+		.fill_rule = PINBLOCK_FILL_CONSTANT,
+		.fill_min = 0xA,
+		.fill_max = 0xA,
+		.pan_binding = false,
+	},
+};
+
+/**
+ * IBM 4704 Encrypting PIN Pad (EPP) PIN block format descriptor. This format
+ * has the same layout as the ISO 9564-1:2017 PIN block formats, with a
+ * constant control field of 0x1 and padding digits of 0xF, but is not
+ * distinguishable from ISO 9564-1:2017 format 1 by its control field.
+ */
+static const struct pinblock_format_desc_t pinblock_ibm4704_desc = {
+	.control = 0x1,
+	.block_size = PINBLOCK_SIZE,
+	.fill_rule = PINBLOCK_FILL_CONSTANT,
+	.fill_min = 0xF,
+	.fill_max = 0xF,
+	.pan_binding = false,
+};
+
+/**
+ * Mastercard Pay Now & Pay Later (PNPL) PIN block format descriptor. This
+ * format has the same PIN field as ISO 9564-1:2017 format 2, but is XOR'd
+ * with the same PAN field as ISO 9564-1:2017 format 0.
+ */
+static const struct pinblock_format_desc_t pinblock_mastercard_pnpl_desc = {
+	.control = PINBLOCK_ISO9564_FORMAT_2,
+	.block_size = PINBLOCK_SIZE,
+	.fill_rule = PINBLOCK_FILL_CONSTANT,
+	.fill_min = 0xF,
+	.fill_max = 0xF,
+	.pan_binding = true,
+};
+
 static void pinblock_pack_pin(uint8_t format, const uint8_t* pin, size_t pin_len, uint8_t fill_digit, uint8_t* pinblock)
 {
 	// Sanitise PIN length
@@ -106,26 +231,18 @@ static void pinblock_pack_pin_with_nonce(uint8_t format, const uint8_t* pin, siz
 	}
 }
 
-static int pinblock_unpack_pin(uint8_t format, const uint8_t* pinblock, uint8_t* pin, size_t* pin_len)
+static int pinblock_unpack_pin(const struct pinblock_format_desc_t* desc, const uint8_t* pinblock, uint8_t* pin, size_t* pin_len)
 {
 	size_t decoded_pin_len;
 
-	switch (format) {
-		case PINBLOCK_ISO9564_FORMAT_0:
-		case PINBLOCK_ISO9564_FORMAT_1:
-		case PINBLOCK_ISO9564_FORMAT_2:
-		case PINBLOCK_ISO9564_FORMAT_3:
-		case PINBLOCK_ISO9564_FORMAT_4:
-			break;
-
-		default:
-			// Unsupported PIN block format
-			return -3;
+	if (desc->fill_rule == PINBLOCK_FILL_NONE) {
+		// Unsupported PIN block format
+		return -3;
 	}
 
 	// First 4 bits are the control field indicating the PIN block format
 	// See ISO 9564-1:2017 9.3.1
-	if (pinblock[0] >> 4 != format) {
+	if (pinblock[0] >> 4 != desc->control) {
 		// Incorrect PIN block format
 		return 2;
 	}
@@ -149,7 +266,7 @@ static int pinblock_unpack_pin(uint8_t format, const uint8_t* pinblock, uint8_t*
 	// For ISO 9564-1:2017 PIN block formats, the PIN starts at the second byte
 	// and padding is only up to the first 8 bytes (16 digits), even for PIN
 	// block format 4
-	for (size_t i = 0; i < 13; ++i) { // Iterate from 3rd digit to 16th digit
+	for (size_t i = 0; i < 14; ++i) { // Iterate from 3rd digit to 16th digit
 		uint8_t digit;
 
 		// Extract digit
@@ -173,32 +290,13 @@ static int pinblock_unpack_pin(uint8_t format, const uint8_t* pinblock, uint8_t*
 			++pin;
 		} else {
 			// Validate padding digit
-			switch (format) {
-				case PINBLOCK_ISO9564_FORMAT_0:
-				case PINBLOCK_ISO9564_FORMAT_2:
-					// See ISO 9564-1:2017 9.3.2.2
-					// See ISO 9564-1:2017 9.3.4
-					if (digit != 0xF) {
-						// Invalid padding digit; either decrypt key or PAN were likely incorrect
-						return -6;
-					}
-					break;
-
-				case PINBLOCK_ISO9564_FORMAT_3:
-					// See ISO 9564-1:2017 9.3.5.2
-					if (digit < 0xA) {
-						// Invalid padding digit; either decrypt key or PAN were likely incorrect
-						return -6;
-					}
-					break;
-
-				case PINBLOCK_ISO9564_FORMAT_4:
-					// See ISO 9564-1:2017 9.4.2.2.2
-					if (digit != 0xA) {
-						// Invalid padding digit; either decrypt key or PAN were likely incorrect
-						return -6;
-					}
-					break;
+			// See ISO 9564-1:2017 9.3.2.2
+			// See ISO 9564-1:2017 9.3.4
+			// See ISO 9564-1:2017 9.3.5.2
+			// See ISO 9564-1:2017 9.4.2.2.2
+			if (digit < desc->fill_min || digit > desc->fill_max) {
+				// Invalid padding digit; either decrypt key or PAN were likely incorrect
+				return -6;
 			}
 		}
 	}
@@ -261,45 +359,101 @@ static void pinblock_pack_pan(const uint8_t* pan, size_t pan_len, uint8_t* panfi
 	}
 }
 
-int pinblock_encode_iso9564_format0(
+static void pinblock_encode_pinfield(
+	const struct pinblock_format_desc_t* desc,
 	const uint8_t* pin,
 	size_t pin_len,
+	const uint8_t* nonce,
+	size_t nonce_len,
 	const uint8_t* pan,
 	size_t pan_len,
 	uint8_t* pinblock
 )
 {
+	uint8_t nonce_input[(PINBLOCK_SIZE - 1) * 2];
+	size_t nonce_input_len;
+	uint8_t nonce_field[PINBLOCK_SIZE];
 	uint8_t panfield[PINBLOCK_SIZE];
 
-	if (!pin || !pin_len || !pan || !pan_len || !pinblock) {
-		return -1;
-	}
+	// Build PIN field
+	switch (desc->fill_rule) {
+		case PINBLOCK_FILL_CONSTANT:
+			// See ISO 9564-1:2017 9.3.2.2
+			// See ISO 9564-1:2017 9.3.4
+			// See ISO 9564-1:2017 9.4.2.2.2
+			pinblock_pack_pin(desc->control, pin, pin_len, desc->fill_min, pinblock);
+			break;
 
-	// Validate PIN length
-	// See ISO 9564-1:2017 8.1
-	// See ISO 9564-1:2017 9.1
-	if (pin_len < 4 || pin_len > 12) {
-		return -2;
-	}
+		case PINBLOCK_FILL_NONCE:
+			// See ISO 9564-1:2017 9.3.3
+			if (!nonce) {
+				// No nonce provided; build random nonce
+				nonce_len = PINBLOCK_SIZE - 1 - (pin_len / 2);
+				crypto_rand(nonce_field, nonce_len);
+			} else {
+				// Populate nonce field in reverse to ensure that the least
+				// significant bytes are used if the nonce is actually the
+				// transaction sequence number (EMV field 9F41)
+				for (size_t i = 0; i < sizeof(nonce_field) && i < nonce_len; ++i) {
+					nonce_field[i] = nonce[nonce_len - 1 - i];
+				}
+			}
+			pinblock_pack_pin_with_nonce(desc->control, pin, pin_len, nonce_field, nonce_len, pinblock);
+			break;
 
-	// Build PIN field
-	// See ISO 9564-1:2017 9.3.2.2
-	pinblock_pack_pin(PINBLOCK_ISO9564_FORMAT_0, pin, pin_len, 0xF, pinblock);
+		case PINBLOCK_FILL_RANDOM_RANGE:
+			// Build nonce consisting only of nibbles within the padding digit
+			// range using one random byte per padding digit such that only
+			// the padding digits that remain after the PIN digits are drawn
+			// from the random source
+			// See ISO 9564-1:2017 9.3.5.2
+			nonce_input_len = (PINBLOCK_SIZE - 1) * 2 - pin_len;
+			crypto_rand(nonce_input, nonce_input_len);
+			for (size_t i = 0; i < nonce_input_len; ++i) {
+				uint8_t scaled_nonce;
+
+				// Scale nonce input to padding digit range
+				scaled_nonce = ((((uint16_t)nonce_input[i]) * (desc->fill_max - desc->fill_min + 1)) >> 8) + desc->fill_min;
+
+				if ((i & 0x1) == 0) { // Even digit index
+					// Most significant nibble
+					nonce_field[i >> 1] = scaled_nonce << 4;
+				} else { // Odd digit index
+					// Least significant nibble
+					nonce_field[i >> 1] |= scaled_nonce & 0xF;
+				}
+			}
+			pinblock_pack_pin_with_nonce(desc->control, pin, pin_len, nonce_field, (nonce_input_len + 1) / 2, pinblock);
+			crypto_cleanse(nonce_input, sizeof(nonce_input));
+			break;
 
-	// Build PAN field
-	// See ISO 9564-1:2017 9.3.2.3
-	pinblock_pack_pan(pan, pan_len, panfield);
+		case PINBLOCK_FILL_NONE:
+			break;
+	}
+	crypto_cleanse(nonce_field, sizeof(nonce_field));
 
-	// Build PIN block
-	// See ISO 9564-1:2017 9.3.2.1
-	crypto_xor(pinblock, panfield, PINBLOCK_SIZE);
+	if (desc->block_size > PINBLOCK_SIZE) {
+		// Build PIN field (last 8 bytes)
+		// See ISO 9564-1:2017 9.4.2.2.2
+		crypto_rand(pinblock + PINBLOCK_SIZE, desc->block_size - PINBLOCK_SIZE);
+	}
 
-	crypto_cleanse(panfield, sizeof(panfield));
+	if (desc->pan_binding) {
+		// Build PAN field
+		// See ISO 9564-1:2017 9.3.2.3
+		// See ISO 9564-1:2017 9.3.5.3
+		pinblock_pack_pan(pan, pan_len, panfield);
 
-	return 0;
+		// Build PIN block
+		// See ISO 9564-1:2017 9.3.2.1
+		// See ISO 9564-1:2017 9.3.5.1
+		crypto_xor(pinblock, panfield, PINBLOCK_SIZE);
+		crypto_cleanse(panfield, sizeof(panfield));
+	}
 }
 
-int pinblock_decode_iso9564_format0(
+static int pinblock_decode_pinfield(
+	const struct pinblock_format_desc_t* desc,
 	const uint8_t* pinblock,
 	size_t pinblock_len,
 	const uint8_t* pan,
@@ -312,29 +466,33 @@ int pinblock_decode_iso9564_format0(
 	uint8_t pinfield[PINBLOCK_SIZE];
 	uint8_t panfield[PINBLOCK_SIZE];
 
-	if (!pinblock || !pinblock_len || !pan || !pan_len || !pin || !pin_len) {
-		return -1;
-	}
 	*pin_len = 0;
 
-	if (pinblock_len != PINBLOCK_SIZE) {
+	if (pinblock_len != desc->block_size) {
 		// Invalid PIN block size
 		return 1;
 	}
 
-	// Extract PIN field from PIN block
-	// See ISO 9564-1:2017 9.3.2.1
+	// For ISO 9564-1:2017 PIN block formats, only the first 8 bytes (16
+	// digits) contain the PIN, even for PIN block format 4
 	memcpy(pinfield, pinblock, PINBLOCK_SIZE);
-	pinblock_pack_pan(pan, pan_len, panfield);
-	crypto_xor(pinfield, panfield, PINBLOCK_SIZE);
 
-	// Sanity check
-	if (memcmp(pinblock, pinfield, 2) != 0) {
-		r = -2;
-		goto error;
+	if (desc->pan_binding) {
+		// Extract PIN field from PIN block
+		// See ISO 9564-1:2017 9.3.2.1
+		// See ISO 9564-1:2017 9.3.5.1
+		pinblock_pack_pan(pan, pan_len, panfield);
+		crypto_xor(pinfield, panfield, PINBLOCK_SIZE);
+		crypto_cleanse(panfield, sizeof(panfield));
+
+		// Sanity check
+		if (memcmp(pinblock, pinfield, 2) != 0) {
+			r = -2;
+			goto error;
+		}
 	}
 
-	r = pinblock_unpack_pin(PINBLOCK_ISO9564_FORMAT_0, pinfield, pin, pin_len);
+	r = pinblock_unpack_pin(desc, pinfield, pin, pin_len);
 	if (r) {
 		goto error;
 	}
@@ -347,11 +505,72 @@ error:
 	crypto_cleanse(pin, 4);
 exit:
 	crypto_cleanse(pinfield, sizeof(pinfield));
-	crypto_cleanse(panfield, sizeof(panfield));
 
 	return r;
 }
 
+int pinblock_encode_iso9564_format0(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock
+)
+{
+	uint8_t panfield[PINBLOCK_SIZE];
+
+	if (!pin || !pin_len || !pan || !pan_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	// See ISO 9564-1:2017 9.1
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	// Build PIN field
+	// See ISO 9564-1:2017 9.3.2.2
+	pinblock_pack_pin(PINBLOCK_ISO9564_FORMAT_0, pin, pin_len, 0xF, pinblock);
+
+	// Build PAN field
+	// See ISO 9564-1:2017 9.3.2.3
+	pinblock_pack_pan(pan, pan_len, panfield);
+
+	// Build PIN block
+	// See ISO 9564-1:2017 9.3.2.1
+	crypto_xor(pinblock, panfield, PINBLOCK_SIZE);
+
+	crypto_cleanse(panfield, sizeof(panfield));
+
+	return 0;
+}
+
+int pinblock_decode_iso9564_format0(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	if (!pinblock || !pinblock_len || !pan || !pan_len || !pin || !pin_len) {
+		return -1;
+	}
+
+	return pinblock_decode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_0],
+		pinblock,
+		pinblock_len,
+		pan,
+		pan_len,
+		pin,
+		pin_len
+	);
+}
+
 int pinblock_encode_iso9564_format1(
 	const uint8_t* pin,
 	size_t pin_len,
@@ -409,31 +628,19 @@ int pinblock_decode_iso9564_format1(
 	size_t* pin_len
 )
 {
-	int r;
-
 	if (!pinblock || !pinblock_len || !pin || !pin_len) {
 		return -1;
 	}
-	*pin_len = 0;
-
-	if (pinblock_len != PINBLOCK_SIZE) {
-		// Invalid PIN block size
-		return 1;
-	}
-
-	r = pinblock_unpack_pin(PINBLOCK_ISO9564_FORMAT_1, pinblock, pin, pin_len);
-	if (r) {
-		goto error;
-	}
-
-	// Success
-	r = 0;
-	goto exit;
 
-error:
-	crypto_cleanse(pin, 4);
-exit:
-	return r;
+	return pinblock_decode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_1],
+		pinblock,
+		pinblock_len,
+		NULL,
+		0,
+		pin,
+		pin_len
+	);
 }
 
 int pinblock_encode_iso9564_format2(
@@ -467,31 +674,19 @@ int pinblock_decode_iso9564_format2(
 	size_t* pin_len
 )
 {
-	int r;
-
 	if (!pinblock || !pinblock_len || !pin || !pin_len) {
 		return -1;
 	}
-	*pin_len = 0;
-
-	if (pinblock_len != PINBLOCK_SIZE) {
-		// Invalid PIN block size
-		return 1;
-	}
-
-	r = pinblock_unpack_pin(PINBLOCK_ISO9564_FORMAT_2, pinblock, pin, pin_len);
-	if (r) {
-		goto error;
-	}
-
-	// Success
-	r = 0;
-	goto exit;
 
-error:
-	crypto_cleanse(pin, 4);
-exit:
-	return r;
+	return pinblock_decode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_2],
+		pinblock,
+		pinblock_len,
+		NULL,
+		0,
+		pin,
+		pin_len
+	);
 }
 
 int pinblock_encode_iso9564_format3(
@@ -503,6 +698,7 @@ int pinblock_encode_iso9564_format3(
 )
 {
 	uint8_t nonce_input[10];
+	size_t nonce_input_len;
 	uint8_t nonce[5];
 	uint8_t panfield[PINBLOCK_SIZE];
 
@@ -517,29 +713,30 @@ int pinblock_encode_iso9564_format3(
 		return -2;
 	}
 
-	// Build 5 byte nonce consisting only of nibbles from 0xA to 0xF
-	// using input of 10 random bytes
+	// Build nonce consisting only of nibbles from 0xA to 0xF using one
+	// random byte per padding digit such that only the padding digits that
+	// remain after the PIN digits are drawn from the random source
 	// See ISO 9564-1:2017 9.3.5.2
-	crypto_rand(nonce_input, sizeof(nonce_input));
-	for (size_t i = 0; i < sizeof(nonce); ++i) {
+	nonce_input_len = (PINBLOCK_SIZE - 1) * 2 - pin_len;
+	crypto_rand(nonce_input, nonce_input_len);
+	for (size_t i = 0; i < nonce_input_len; ++i) {
 		uint8_t scaled_nonce;
 
 		// Scale nonce input to range from 0xA to 0xF
-		scaled_nonce = ((((uint16_t)nonce_input[i * 2]) * 6) >> 8) + 0xA;
-
-		// Pack most significant nibble
-		nonce[i] = scaled_nonce << 4;
-
-		// Scale next nonce input to range from 0xA to 0xF
-		scaled_nonce = ((((uint16_t)nonce_input[i * 2 + 1]) * 6) >> 8) + 0xA;
+		scaled_nonce = ((((uint16_t)nonce_input[i]) * 6) >> 8) + 0xA;
 
-		// Pack most significant nibble
-		nonce[i] |= scaled_nonce & 0xF;
+		if ((i & 0x1) == 0) { // Even digit index
+			// Most significant nibble
+			nonce[i >> 1] = scaled_nonce << 4;
+		} else { // Odd digit index
+			// Least significant nibble
+			nonce[i >> 1] |= scaled_nonce & 0xF;
+		}
 	}
 
 	// Build PIN field
 	// See ISO 9564-1:2017 9.3.5.2
-	pinblock_pack_pin_with_nonce(PINBLOCK_ISO9564_FORMAT_3, pin, pin_len, nonce, sizeof(nonce), pinblock);
+	pinblock_pack_pin_with_nonce(PINBLOCK_ISO9564_FORMAT_3, pin, pin_len, nonce, (nonce_input_len + 1) / 2, pinblock);
 
 	// Build PAN field
 	// See ISO 9564-1:2017 9.3.5.3
@@ -565,48 +762,19 @@ int pinblock_decode_iso9564_format3(
 	size_t* pin_len
 )
 {
-	int r;
-	uint8_t pinfield[PINBLOCK_SIZE];
-	uint8_t panfield[PINBLOCK_SIZE];
-
 	if (!pinblock || !pinblock_len || !pan || !pan_len || !pin || !pin_len) {
 		return -1;
 	}
-	*pin_len = 0;
-
-	if (pinblock_len != PINBLOCK_SIZE) {
-		// Invalid PIN block size
-		return 1;
-	}
-
-	// Extract PIN field from PIN block
-	// See ISO 9564-1:2017 9.3.5.1
-	memcpy(pinfield, pinblock, PINBLOCK_SIZE);
-	pinblock_pack_pan(pan, pan_len, panfield);
-	crypto_xor(pinfield, panfield, PINBLOCK_SIZE);
-
-	// Sanity check
-	if (memcmp(pinblock, pinfield, 2) != 0) {
-		r = -2;
-		goto error;
-	}
-
-	r = pinblock_unpack_pin(PINBLOCK_ISO9564_FORMAT_3, pinfield, pin, pin_len);
-	if (r) {
-		goto error;
-	}
-
-	// Success
-	r = 0;
-	goto exit;
-
-error:
-	crypto_cleanse(pin, 4);
-exit:
-	crypto_cleanse(pinfield, sizeof(pinfield));
-	crypto_cleanse(panfield, sizeof(panfield));
 
-	return r;
+	return pinblock_decode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_3],
+		pinblock,
+		pinblock_len,
+		pan,
+		pan_len,
+		pin,
+		pin_len
+	);
 }
 
 int pinblock_encode_iso9564_format4_pinfield(
@@ -637,22 +805,32 @@ int pinblock_encode_iso9564_format4_pinfield(
 	return 0;
 }
 
-int pinblock_encode_iso9564_format4_panfield(
-	const uint8_t* pan,
-	size_t pan_len,
-	uint8_t* panfield
-)
+static void pinblock_pack_format4_pan(const uint8_t* pan, size_t pan_len, uint8_t* panfield)
 {
-	if (!pan || !pan_len || !panfield) {
-		return -1;
+	size_t pan_digit_count = 0;
+
+	// Count PAN digits, excluding padding, such that the PAN buffer length
+	// does not determine M
+	while (pan_digit_count < pan_len * 2) {
+		uint8_t digit;
+
+		if ((pan_digit_count & 0x1) == 0) { // Even digit index
+			// Most significant nibble
+			digit = pan[pan_digit_count >> 1] >> 4;
+		} else { // Odd digit index
+			// Least significant nibble
+			digit = pan[pan_digit_count >> 1] & 0xF;
+		}
+		if (digit == 0xF) {
+			break;
+		}
+		++pan_digit_count;
 	}
 
 	// Build PAN field
 	// See ISO 9564-1:2017 9.4.2.2.3
 	memset(panfield, 0, PINBLOCK128_SIZE);
-	if (pan_len < 6 ||
-		(pan_len == 6 &&(pan[pan_len - 1] & 0xF) == 0xF)
-	) {
+	if (pan_digit_count < 12) {
 		// If PAN is less than 12 digits, M is zero
 		// PAN digits will be right justified and left padded with zeros
 
@@ -737,6 +915,19 @@ int pinblock_encode_iso9564_format4_panfield(
 		// Populate M
 		panfield[0] |= (pan_idx - 12) << 4;
 	}
+}
+
+int pinblock_encode_iso9564_format4_panfield(
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* panfield
+)
+{
+	if (!pan || !pan_len || !panfield) {
+		return -1;
+	}
+
+	pinblock_pack_format4_pan(pan, pan_len, panfield);
 
 	return 0;
 }
@@ -748,63 +939,40 @@ int pinblock_decode_iso9564_format4_pinfield(
 	size_t* pin_len
 )
 {
-	int r;
-
 	if (!pinfield || !pin || !pin_len) {
 		return -1;
 	}
-	*pin_len = 0;
 
-	if (pinfield_len != PINBLOCK128_SIZE) {
-		// Invalid PIN block size
-		return 1;
-	}
-
-	// Decode PIN
-	r = pinblock_unpack_pin(PINBLOCK_ISO9564_FORMAT_4, pinfield, pin, pin_len);
-	if (r) {
-		goto error;
-	}
-
-	// Success
-	r = 0;
-	goto exit;
-
-error:
-	crypto_cleanse(pin, 4);
-exit:
-	return r;
-}
+	return pinblock_decode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_4],
+		pinfield,
+		pinfield_len,
+		NULL,
+		0,
+		pin,
+		pin_len
+	);
+}
 
 int pinblock_get_format(const uint8_t* pinblock, size_t pinblock_len)
 {
 	uint8_t format;
 
-	if (pinblock_len == PINBLOCK_SIZE) {
-		// First 4 bits are the control field indicating the PIN block format
-		// See ISO 9564-1:2017 9.3.1
-		format = pinblock[0] >> 4;
-
-		switch (format) {
-			case PINBLOCK_ISO9564_FORMAT_0:
-			case PINBLOCK_ISO9564_FORMAT_1:
-			case PINBLOCK_ISO9564_FORMAT_2:
-			case PINBLOCK_ISO9564_FORMAT_3:
-				return format;
-		}
+	if (!pinblock || !pinblock_len) {
+		return -1;
+	}
 
-	} else if (pinblock_len == PINBLOCK128_SIZE) {
-		// First 4 bits are the control field indicating the PIN block format
-		// See ISO 9564-1:2017 9.4.2.2.2
-		format = pinblock[0] >> 4;
+	// First 4 bits are the control field indicating the PIN block format
+	// See ISO 9564-1:2017 9.3.1
+	// See ISO 9564-1:2017 9.4.2.2.2
+	format = pinblock[0] >> 4;
 
-		switch (format) {
-			case PINBLOCK_ISO9564_FORMAT_4:
-				return format;
-		}
+	// Unsupported formats have a zero block size and never match
+	if (pinblock_format_desc[format].block_size != pinblock_len) {
+		return -1;
 	}
 
-	return -1;
+	return format;
 }
 
 int pinblock_decode(
@@ -817,72 +985,2658 @@ int pinblock_decode(
 	size_t* pin_len
 )
 {
+	const struct pinblock_format_desc_t* desc;
+
 	if (!pinblock || !pinblock_len || !format || !pin || !pin_len) {
 		return -1;
 	}
 
-	if (pinblock_len == PINBLOCK_SIZE) {
-		// First 4 bits are the control field indicating the PIN block format
-		// See ISO 9564-1:2017 9.3.1
-		*format = pinblock[0] >> 4;
+	if (pinblock_len != PINBLOCK_SIZE && pinblock_len != PINBLOCK128_SIZE) {
+		// Unsupported PIN block size
+		return 1;
+	}
 
-		switch (*format) {
-			case PINBLOCK_ISO9564_FORMAT_0:
-				return pinblock_decode_iso9564_format0(
-					pinblock,
-					pinblock_len,
-					other,
-					other_len,
-					pin,
-					pin_len
-				);
+	// First 4 bits are the control field indicating the PIN block format
+	// See ISO 9564-1:2017 9.3.1
+	// See ISO 9564-1:2017 9.4.2.2.2
+	*format = pinblock[0] >> 4;
+	desc = &pinblock_format_desc[*format];
 
-			case PINBLOCK_ISO9564_FORMAT_1:
-				return pinblock_decode_iso9564_format1(
-					pinblock,
-					pinblock_len,
-					pin,
-					pin_len
-				);
+	if (desc->block_size != pinblock_len) {
+		if (pinblock_len == PINBLOCK_SIZE) {
+			// Unsupported PIN block format
+			return 5;
+		}
 
-			case PINBLOCK_ISO9564_FORMAT_2:
-				return pinblock_decode_iso9564_format2(
-					pinblock,
-					pinblock_len,
-					pin,
-					pin_len
-				);
+		// Unsupported PIN block size
+		return 1;
+	}
 
-			case PINBLOCK_ISO9564_FORMAT_3:
-				return pinblock_decode_iso9564_format3(
-					pinblock,
-					pinblock_len,
-					other,
-					other_len,
-					pin,
-					pin_len
-				);
+	if (desc->pan_binding && (!other || !other_len)) {
+		return -1;
+	}
+
+	return pinblock_decode_pinfield(
+		desc,
+		pinblock,
+		pinblock_len,
+		other,
+		other_len,
+		pin,
+		pin_len
+	);
+}
+
+// Number of calls after which a thread checks for a configuration change
+// while shadow verification is disabled
+#define PINBLOCK_SHADOW_DISABLED_POLL (65536)
+
+#ifndef __STDC_NO_ATOMICS__
+static atomic_uint pinblock_shadow_interval;
+static atomic_uint pinblock_shadow_max_per_second;
+static atomic_ulong pinblock_shadow_rate_second;
+static atomic_uint pinblock_shadow_rate_count;
+static atomic_ulong pinblock_shadow_verified;
+static atomic_ulong pinblock_shadow_mismatched;
+static atomic_ulong pinblock_shadow_rate_limited;
+
+// Per-thread countdown to the next sampled call such that sampling requires
+// neither atomic operations nor division
+static _Thread_local unsigned int pinblock_shadow_countdown;
+static pinblock_shadow_callback_t pinblock_shadow_callback;
+static void* pinblock_shadow_ctx;
+#endif
+
+int pinblock_shadow_configure(
+	unsigned int sample_interval,
+	unsigned int max_per_second,
+	pinblock_shadow_callback_t callback,
+	void* ctx
+)
+{
+#ifdef __STDC_NO_ATOMICS__
+	(void)max_per_second;
+	(void)callback;
+	(void)ctx;
+
+	if (sample_interval) {
+		// Shadow verification requires atomics
+		return 1;
+	}
+
+	return 0;
+#else
+	// Disable sampling while updating the configuration
+	atomic_store(&pinblock_shadow_interval, 0);
+	pinblock_shadow_callback = callback;
+	pinblock_shadow_ctx = ctx;
+	atomic_store(&pinblock_shadow_max_per_second, max_per_second);
+	atomic_store(&pinblock_shadow_rate_second, 0);
+	atomic_store(&pinblock_shadow_rate_count, 0);
+	atomic_store(&pinblock_shadow_verified, 0);
+	atomic_store(&pinblock_shadow_mismatched, 0);
+	atomic_store(&pinblock_shadow_rate_limited, 0);
+	atomic_store(&pinblock_shadow_interval, sample_interval);
+
+	// Apply new configuration to the calling thread immediately
+	pinblock_shadow_countdown = 0;
+
+	return 0;
+#endif
+}
+
+void pinblock_shadow_get_stats(struct pinblock_shadow_stats_t* stats)
+{
+	if (!stats) {
+		return;
+	}
+
+#ifdef __STDC_NO_ATOMICS__
+	stats->verified = 0;
+	stats->mismatched = 0;
+	stats->rate_limited = 0;
+#else
+	stats->verified = atomic_load(&pinblock_shadow_verified);
+	stats->mismatched = atomic_load(&pinblock_shadow_mismatched);
+	stats->rate_limited = atomic_load(&pinblock_shadow_rate_limited);
+#endif
+}
+
+#ifndef __STDC_NO_ATOMICS__
+static bool pinblock_shadow_sample_slow(void)
+{
+	unsigned int interval;
+	unsigned int max_per_second;
+	unsigned long second;
+	unsigned long rate_second;
+
+	interval = atomic_load_explicit(&pinblock_shadow_interval, memory_order_relaxed);
+	if (!interval) {
+		// Shadow verification disabled; check again later
+		pinblock_shadow_countdown = PINBLOCK_SHADOW_DISABLED_POLL;
+		return false;
+	}
+	pinblock_shadow_countdown = interval;
+
+	max_per_second = atomic_load_explicit(&pinblock_shadow_max_per_second, memory_order_relaxed);
+	if (max_per_second) {
+		// Limit number of verifications per second across all threads
+		second = (unsigned long)time(NULL);
+		rate_second = atomic_load_explicit(&pinblock_shadow_rate_second, memory_order_relaxed);
+		if (rate_second != second &&
+			atomic_compare_exchange_strong(&pinblock_shadow_rate_second, &rate_second, second)
+		) {
+			atomic_store_explicit(&pinblock_shadow_rate_count, 0, memory_order_relaxed);
+		}
+		if (atomic_fetch_add_explicit(&pinblock_shadow_rate_count, 1, memory_order_relaxed) >= max_per_second) {
+			atomic_fetch_add_explicit(&pinblock_shadow_rate_limited, 1, memory_order_relaxed);
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif
+
+static inline bool pinblock_shadow_sample(void)
+{
+#ifdef __STDC_NO_ATOMICS__
+	return false;
+#else
+	if (pinblock_shadow_countdown > 1) {
+		--pinblock_shadow_countdown;
+		return false;
+	}
+
+	return pinblock_shadow_sample_slow();
+#endif
+}
 
-			default:
-				return 5;
+static void pinblock_shadow_report(const char* kernel, bool match)
+{
+#ifdef __STDC_NO_ATOMICS__
+	(void)kernel;
+	(void)match;
+#else
+	atomic_fetch_add_explicit(&pinblock_shadow_verified, 1, memory_order_relaxed);
+	if (!match) {
+		atomic_fetch_add_explicit(&pinblock_shadow_mismatched, 1, memory_order_relaxed);
+		if (pinblock_shadow_callback) {
+			pinblock_shadow_callback(kernel, pinblock_shadow_ctx);
 		}
+	}
+#endif
+}
 
-	} else if (pinblock_len == PINBLOCK128_SIZE) {
-		// First 4 bits are the control field indicating the PIN block format
+static void pinblock_shadow_verify_decode(
+	const char* kernel,
+	const struct pinblock_format_desc_t* desc,
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	int r,
+	const uint8_t* pin_bcd
+)
+{
+	int r_ref;
+	uint8_t pin_ref[12];
+	size_t pin_ref_len;
+	uint8_t pin_bcd_ref[PINBLOCK_SIZE];
+	bool match;
+
+	// Decode using reference implementation
+	r_ref = pinblock_decode_pinfield(desc, pinblock, pinblock_len, pan, pan_len, pin_ref, &pin_ref_len);
+	if (r != r_ref) {
+		match = false;
+	} else if (r) {
+		// Both implementations failed with the same error
+		match = true;
+	} else if (pin_bcd) {
+		// Compare PIN length and PIN digits in constant time
+		pinblock_pack_pin(0, pin_ref, pin_ref_len, 0xF, pin_bcd_ref);
+		match = crypto_memcmp_s(pin_bcd_ref, pin_bcd, PINBLOCK_PIN_BCD_SIZE) == 0;
+		crypto_cleanse(pin_bcd_ref, sizeof(pin_bcd_ref));
+	} else {
+		match = true;
+	}
+	crypto_cleanse(pin_ref, sizeof(pin_ref));
+
+	pinblock_shadow_report(kernel, match);
+}
+
+static void pinblock_shadow_verify_convert(
+	const uint8_t* pinblock,
+	const uint8_t* pan,
+	size_t pan_len,
+	const struct pinblock_format_desc_t* desc,
+	int r,
+	const uint8_t* converted_pinblock
+)
+{
+	int r_ref;
+	uint8_t pin_ref[12];
+	size_t pin_ref_len;
+	uint8_t pin[12];
+	size_t pin_len;
+	bool match;
+
+	// Decode both the original and the converted PIN block using the
+	// reference implementation
+	r_ref = pinblock_decode_pinfield(
+		&pinblock_format_desc[pinblock[0] >> 4],
+		pinblock,
+		PINBLOCK_SIZE,
+		pan,
+		pan_len,
+		pin_ref,
+		&pin_ref_len
+	);
+	if (r != r_ref) {
+		match = false;
+	} else if (r) {
+		// Both implementations failed with the same error
+		match = true;
+	} else {
+		r_ref = pinblock_decode_pinfield(desc, converted_pinblock, PINBLOCK_SIZE, pan, pan_len, pin, &pin_len);
+		match = !r_ref &&
+			pin_len == pin_ref_len &&
+			crypto_memcmp_s(pin, pin_ref, pin_ref_len) == 0;
+		crypto_cleanse(pin, sizeof(pin));
+	}
+	crypto_cleanse(pin_ref, sizeof(pin_ref));
+
+	pinblock_shadow_report("pinblock_convert", match);
+}
+
+static void pinblock_shadow_verify_format0_format4(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	const uint8_t* pinblock,
+	const uint8_t* pinfield
+)
+{
+	int r;
+	uint8_t pinblock_ref[PINBLOCK_SIZE];
+	uint8_t pin_ref[12];
+	size_t pin_ref_len;
+	bool match;
+
+	// Encode format 0 PIN block using reference implementation
+	pinblock_encode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_0],
+		pin,
+		pin_len,
+		NULL,
+		0,
+		pan,
+		pan_len,
+		pinblock_ref
+	);
+	match = crypto_memcmp_s(pinblock_ref, pinblock, PINBLOCK_SIZE) == 0;
+	crypto_cleanse(pinblock_ref, sizeof(pinblock_ref));
+
+	// Decode format 4 PIN field using reference implementation
+	r = pinblock_decode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_4],
+		pinfield,
+		PINBLOCK128_SIZE,
+		NULL,
+		0,
+		pin_ref,
+		&pin_ref_len
+	);
+	match = match &&
+		!r &&
+		pin_ref_len == pin_len &&
+		crypto_memcmp_s(pin_ref, pin, pin_len) == 0;
+	crypto_cleanse(pin_ref, sizeof(pin_ref));
+
+	pinblock_shadow_report("pinblock_encode_iso9564_format0_format4", match);
+}
+
+static inline uint64_t pinblock_load64(const uint8_t* buf)
+{
+	uint64_t x = 0;
+
+	// Big endian such that the first digit is the most significant nibble
+	for (size_t i = 0; i < PINBLOCK_SIZE; ++i) {
+		x = (x << 8) | buf[i];
+	}
+	return x;
+}
+
+static inline void pinblock_store64(uint64_t x, uint8_t* buf)
+{
+	for (size_t i = PINBLOCK_SIZE; i > 0; --i) {
+		buf[i - 1] = x;
+		x >>= 8;
+	}
+}
+
+/// Nibble mask with the least significant bit of each nibble set
+#define PINBLOCK_NIBBLE_LSB (0x1111111111111111ULL)
+
+static inline uint64_t pinblock_pin_mask(size_t pin_len)
+{
+	// Control field, PIN length field and PIN digits of PIN field
+	return ~(UINT64_MAX >> (8 + 4 * pin_len));
+}
+
+static inline uint64_t pinblock_nondecimal_nibbles(uint64_t x)
+{
+	// A nibble is greater than 0x9 if its most significant bit is set
+	// together with either of its middle bits. The result has the least
+	// significant bit of each such nibble set.
+	return (x >> 3) & ((x >> 2) | (x >> 1)) & PINBLOCK_NIBBLE_LSB;
+}
+
+static void pinblock_shadow_verify_encode_bcd(
+	unsigned int format,
+	const uint8_t* pin_bcd,
+	const uint8_t* other,
+	size_t other_len,
+	const uint8_t* pinblock,
+	size_t pinblock_len
+)
+{
+	int r;
+	unsigned int decoded_format;
+	uint8_t pin_ref[12];
+	size_t pin_ref_len;
+	uint8_t pin_bcd_ref[PINBLOCK_SIZE];
+	uint8_t pin_bcd_input[PINBLOCK_SIZE];
+	uint64_t pin_mask;
+	bool match;
+
+	// Decode using reference implementation
+	r = pinblock_decode(pinblock, pinblock_len, other, other_len, &decoded_format, pin_ref, &pin_ref_len);
+	if (r) {
+		match = false;
+	} else {
+		// Compare PIN length and PIN digits in constant time, ignoring the
+		// unused digits of the packed BCD PIN input
+		pinblock_pack_pin(0, pin_ref, pin_ref_len, 0xF, pin_bcd_ref);
+		memcpy(pin_bcd_input, pin_bcd, PINBLOCK_PIN_BCD_SIZE);
+		pin_bcd_input[PINBLOCK_PIN_BCD_SIZE] = 0;
+		pin_mask = pinblock_pin_mask(pin_ref_len);
+		pinblock_store64((pinblock_load64(pin_bcd_input) & pin_mask) | ~pin_mask, pin_bcd_input);
+		match = decoded_format == format &&
+			crypto_memcmp_s(pin_bcd_ref, pin_bcd_input, PINBLOCK_PIN_BCD_SIZE) == 0;
+		crypto_cleanse(pin_bcd_ref, sizeof(pin_bcd_ref));
+		crypto_cleanse(pin_bcd_input, sizeof(pin_bcd_input));
+	}
+	crypto_cleanse(pin_ref, sizeof(pin_ref));
+
+	pinblock_shadow_report("pinblock_encode_bcd", match);
+}
+
+static void pinblock_shadow_verify_rebind(
+	const uint8_t* pinblock,
+	const uint8_t* old_pan,
+	size_t old_pan_len,
+	const uint8_t* new_pan,
+	size_t new_pan_len,
+	const uint8_t* rebound_pinblock
+)
+{
+	int r;
+	int r_ref;
+	unsigned int format;
+	unsigned int format_ref;
+	uint8_t pin[12];
+	size_t pin_len;
+	uint8_t pin_ref[12];
+	size_t pin_ref_len;
+	uint8_t pinblock_ref[PINBLOCK_SIZE];
+	bool match;
+
+	// Decode the original PIN block using the old PAN, and the rebound PIN
+	// block using the new PAN, using the reference implementation
+	r_ref = pinblock_decode(pinblock, PINBLOCK_SIZE, old_pan, old_pan_len, &format_ref, pin_ref, &pin_ref_len);
+	r = pinblock_decode(rebound_pinblock, PINBLOCK_SIZE, new_pan, new_pan_len, &format, pin, &pin_len);
+	if (r != r_ref) {
+		match = false;
+	} else if (r) {
+		// Both PIN blocks are invalid in the same way
+		match = true;
+	} else if (format_ref == PINBLOCK_ISO9564_FORMAT_0) {
+		// Format 0 is deterministic; re-encode the PIN using the new PAN
+		r_ref = pinblock_encode_iso9564_format0(pin_ref, pin_ref_len, new_pan, new_pan_len, pinblock_ref);
+		match = !r_ref &&
+			crypto_memcmp_s(pinblock_ref, rebound_pinblock, PINBLOCK_SIZE) == 0;
+		crypto_cleanse(pinblock_ref, sizeof(pinblock_ref));
+	} else {
+		// Other formats have random padding; compare the decoded PINs
+		match = format == format_ref &&
+			pin_len == pin_ref_len &&
+			crypto_memcmp_s(pin, pin_ref, pin_ref_len) == 0;
+	}
+	crypto_cleanse(pin, sizeof(pin));
+	crypto_cleanse(pin_ref, sizeof(pin_ref));
+
+	pinblock_shadow_report("pinblock_rebind_pan", match);
+}
+
+static int pinblock_validate_pinfield64(const struct pinblock_format_desc_t* desc, uint64_t pinfield)
+{
+	size_t pin_len;
+	uint64_t pin_mask;
+	uint64_t fill_mask;
+
+	if (desc->fill_rule == PINBLOCK_FILL_NONE) {
+		// Unsupported PIN block format
+		return -3;
+	}
+
+	// First 4 bits are the control field indicating the PIN block format
+	// See ISO 9564-1:2017 9.3.1
+	if ((pinfield >> 60) != desc->control) {
+		// Incorrect PIN block format
+		return 2;
+	}
+
+	// Second 4 bits indicate PIN length
+	// See ISO 9564-1:2017 8.1
+	// See ISO 9564-1:2017 9.1
+	pin_len = (pinfield >> 56) & 0xF;
+	if (pin_len < 4 || pin_len > 12) {
+		return -4;
+	}
+	pin_mask = pinblock_pin_mask(pin_len) & (UINT64_MAX >> 8);
+	fill_mask = ~pinblock_pin_mask(pin_len);
+
+	// Validate PIN digits
+	if (pinblock_nondecimal_nibbles(pinfield) & pin_mask) {
+		// Invalid PIN digit; either decrypt key or PAN were likely incorrect
+		return -5;
+	}
+
+	// Validate padding digits
+	// See ISO 9564-1:2017 9.3.2.2
+	// See ISO 9564-1:2017 9.3.4
+	// See ISO 9564-1:2017 9.3.5.2
+	// See ISO 9564-1:2017 9.4.2.2.2
+	if (desc->fill_min == desc->fill_max) {
+		// Constant padding digit
+		if ((pinfield ^ (PINBLOCK_NIBBLE_LSB * desc->fill_min)) & fill_mask) {
+			// Invalid padding digit; either decrypt key or PAN were likely incorrect
+			return -6;
+		}
+	} else if (desc->fill_min == 0xA && desc->fill_max == 0xF) {
+		// Non-decimal padding digits
+		if ((~pinblock_nondecimal_nibbles(pinfield) & PINBLOCK_NIBBLE_LSB) & fill_mask) {
+			// Invalid padding digit; either decrypt key or PAN were likely incorrect
+			return -6;
+		}
+	} else if (desc->fill_min != 0x0 || desc->fill_max != 0xF) {
+		// Arbitrary padding digit range
+		for (size_t i = 0; i < 14 - pin_len; ++i) {
+			uint8_t digit = (pinfield >> (i * 4)) & 0xF;
+			if (digit < desc->fill_min || digit > desc->fill_max) {
+				// Invalid padding digit; either decrypt key or PAN were likely incorrect
+				return -6;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static uint64_t pinblock_build_fill64(
+	const struct pinblock_format_desc_t* desc,
+	size_t pin_len,
+	const uint8_t* nonce,
+	size_t nonce_len
+)
+{
+	uint8_t buf[(PINBLOCK_SIZE - 1) * 2];
+	uint64_t fill;
+
+	switch (desc->fill_rule) {
+		case PINBLOCK_FILL_CONSTANT:
+			// See ISO 9564-1:2017 9.3.2.2
+			// See ISO 9564-1:2017 9.3.4
+			// See ISO 9564-1:2017 9.4.2.2.2
+			fill = PINBLOCK_NIBBLE_LSB * desc->fill_min;
+			break;
+
+		case PINBLOCK_FILL_NONCE:
+			// See ISO 9564-1:2017 9.3.3
+			if (!nonce) {
+				// No nonce provided; use random nonce
+				crypto_rand(buf, PINBLOCK_SIZE);
+			} else {
+				// Populate nonce in reverse to ensure that the least
+				// significant bytes are used if the nonce is actually the
+				// transaction sequence number (EMV field 9F41)
+				memset(buf, 0, PINBLOCK_SIZE);
+				for (size_t i = 0; i < PINBLOCK_SIZE && i < nonce_len; ++i) {
+					buf[i] = nonce[nonce_len - 1 - i];
+				}
+			}
+
+			// Nonce digits start after the PIN digits
+			fill = pinblock_load64(buf) >> (8 + 4 * pin_len);
+			break;
+
+		case PINBLOCK_FILL_RANDOM_RANGE:
+			// Scale one random byte per padding digit to padding digit range
+			// See ISO 9564-1:2017 9.3.5.2
+			crypto_rand(buf, (PINBLOCK_SIZE - 1) * 2 - pin_len);
+			fill = 0;
+			for (size_t i = 0; i < (PINBLOCK_SIZE - 1) * 2 - pin_len; ++i) {
+				uint64_t scaled_nonce;
+
+				scaled_nonce = ((((uint16_t)buf[i]) * (desc->fill_max - desc->fill_min + 1)) >> 8) + desc->fill_min;
+				fill = (fill << 4) | scaled_nonce;
+			}
+			break;
+
+		default:
+			fill = 0;
+			break;
+	}
+
+	crypto_cleanse(buf, sizeof(buf));
+
+	return fill;
+}
+
+int pinblock_encode_bcd(
+	unsigned int format,
+	const uint8_t* pin_bcd,
+	const uint8_t* other,
+	size_t other_len,
+	uint8_t* pinblock,
+	size_t pinblock_len
+)
+{
+	int r;
+	const struct pinblock_format_desc_t* desc;
+	size_t pin_len;
+	uint8_t buf[PINBLOCK_SIZE];
+	uint64_t pin;
+	uint64_t pin_mask;
+	uint64_t fill;
+	uint64_t pinfield;
+
+	if (!pin_bcd || !pinblock || !pinblock_len) {
+		return -1;
+	}
+
+	// Validate PIN block format
+	if (format > 0xF || pinblock_format_desc[format].block_size == 0) {
+		return -3;
+	}
+	desc = &pinblock_format_desc[format];
+	if (pinblock_len != desc->block_size) {
+		// Invalid PIN block size
+		return 1;
+	}
+	if (desc->pan_binding && (!other || !other_len)) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	// See ISO 9564-1:2017 9.1
+	pin_len = pin_bcd[0];
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	// Validate PIN digits
+	memcpy(buf, pin_bcd, PINBLOCK_PIN_BCD_SIZE);
+	buf[PINBLOCK_PIN_BCD_SIZE] = 0;
+	pin = pinblock_load64(buf);
+	pinfield = 0;
+	pin_mask = pinblock_pin_mask(pin_len);
+	if (pinblock_nondecimal_nibbles(pin) & pin_mask & (UINT64_MAX >> 8)) {
+		r = -2;
+		goto exit;
+	}
+
+	if (desc->fill_rule == PINBLOCK_FILL_NONCE && other) {
+		// Validate nonce length
+		if (other_len < PINBLOCK_SIZE - 1 - (pin_len / 2)) {
+			r = -3;
+			goto exit;
+		}
+	}
+
+	// Build padding digits
+	fill = pinblock_build_fill64(
+		desc,
+		pin_len,
+		desc->fill_rule == PINBLOCK_FILL_NONCE ? other : NULL,
+		other_len
+	);
+
+	// Build PIN field
+	pinfield = ((uint64_t)desc->control << 60) |
+		(pin & pin_mask) |
+		(fill & ~pin_mask);
+	pinblock_store64(pinfield, pinblock);
+
+	if (desc->block_size > PINBLOCK_SIZE) {
+		// Build PIN field (last 8 bytes)
 		// See ISO 9564-1:2017 9.4.2.2.2
-		*format = pinblock[0] >> 4;
+		crypto_rand(pinblock + PINBLOCK_SIZE, desc->block_size - PINBLOCK_SIZE);
+	}
 
-		switch (*format) {
-			case PINBLOCK_ISO9564_FORMAT_4:
-				return pinblock_decode_iso9564_format4_pinfield(
-					pinblock,
-					pinblock_len,
-					pin,
-					pin_len
-				);
+	if (desc->pan_binding) {
+		// Build PIN block
+		// See ISO 9564-1:2017 9.3.2.1
+		// See ISO 9564-1:2017 9.3.5.1
+		pinblock_pack_pan(other, other_len, buf);
+		crypto_xor(pinblock, buf, PINBLOCK_SIZE);
+	}
+
+	if (pinblock_shadow_sample()) {
+		pinblock_shadow_verify_encode_bcd(format, pin_bcd, other, other_len, pinblock, pinblock_len);
+	}
+
+	// Success
+	r = 0;
+
+exit:
+	crypto_cleanse(buf, sizeof(buf));
+	crypto_cleanse(&pin, sizeof(pin));
+	crypto_cleanse(&pinfield, sizeof(pinfield));
+
+	return r;
+}
+
+int pinblock_decode_bcd(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* other,
+	size_t other_len,
+	unsigned int* format,
+	uint8_t* pin_bcd
+)
+{
+	int r;
+	const struct pinblock_format_desc_t* desc;
+	uint8_t buf[PINBLOCK_SIZE];
+	uint64_t pinfield;
+	uint64_t pin_mask;
+
+	if (!pinblock || !pinblock_len || !format || !pin_bcd) {
+		return -1;
+	}
+
+	if (pinblock_len != PINBLOCK_SIZE && pinblock_len != PINBLOCK128_SIZE) {
+		// Unsupported PIN block size
+		return 1;
+	}
+
+	// First 4 bits are the control field indicating the PIN block format
+	// See ISO 9564-1:2017 9.3.1
+	// See ISO 9564-1:2017 9.4.2.2.2
+	*format = pinblock[0] >> 4;
+	desc = &pinblock_format_desc[*format];
+
+	if (desc->block_size != pinblock_len) {
+		if (pinblock_len == PINBLOCK_SIZE) {
+			// Unsupported PIN block format
+			return 5;
+		}
+
+		// Unsupported PIN block size
+		return 1;
+	}
+
+	if (desc->pan_binding && (!other || !other_len)) {
+		return -1;
+	}
+
+	pinfield = pinblock_load64(pinblock);
+	if (desc->pan_binding) {
+		// Extract PIN field from PIN block
+		// See ISO 9564-1:2017 9.3.2.1
+		// See ISO 9564-1:2017 9.3.5.1
+		pinblock_pack_pan(other, other_len, buf);
+		pinfield ^= pinblock_load64(buf);
+		crypto_cleanse(buf, sizeof(buf));
+	}
+
+	r = pinblock_validate_pinfield64(desc, pinfield);
+	if (!r) {
+		// Extract PIN length and PIN digits, and replace padding digits
+		pin_mask = pinblock_pin_mask((pinfield >> 56) & 0xF);
+		pinfield = (pinfield & pin_mask & (UINT64_MAX >> 4)) | ~pin_mask;
+		pinblock_store64(pinfield, buf);
+		memcpy(pin_bcd, buf, PINBLOCK_PIN_BCD_SIZE);
+		crypto_cleanse(buf, sizeof(buf));
+	}
+
+	if (pinblock_shadow_sample()) {
+		pinblock_shadow_verify_decode(
+			"pinblock_decode_bcd",
+			desc,
+			pinblock,
+			pinblock_len,
+			other,
+			other_len,
+			r,
+			pin_bcd
+		);
+	}
+
+	crypto_cleanse(&pinfield, sizeof(pinfield));
+
+	return r;
+}
+
+static inline bool pinblock_is_pan_bound(const uint8_t* pinblock)
+{
+	const struct pinblock_format_desc_t* desc;
+	uint8_t pin_len;
+
+	// First 4 bits are the control field indicating the PIN block format
+	// and the second 4 bits indicate the PIN length. Neither is affected by
+	// the PAN field.
+	// See ISO 9564-1:2017 9.3.2.3
+	// See ISO 9564-1:2017 9.3.5.3
+	desc = &pinblock_format_desc[pinblock[0] >> 4];
+	pin_len = pinblock[0] & 0xF;
+
+	return desc->pan_binding &&
+		desc->block_size == PINBLOCK_SIZE &&
+		pin_len >= 4 && pin_len <= 12;
+}
+
+static int pinblock_build_rebind_delta(
+	const uint8_t* old_pan,
+	size_t old_pan_len,
+	const uint8_t* new_pan,
+	size_t new_pan_len,
+	uint64_t* delta
+)
+{
+	uint8_t panfield[PINBLOCK_SIZE];
+
+	if (!old_pan || !old_pan_len || !new_pan || !new_pan_len) {
+		return -1;
+	}
+
+	// Old PAN field XOR new PAN field
+	pinblock_pack_pan(old_pan, old_pan_len, panfield);
+	*delta = pinblock_load64(panfield);
+	pinblock_pack_pan(new_pan, new_pan_len, panfield);
+	*delta ^= pinblock_load64(panfield);
+	crypto_cleanse(panfield, sizeof(panfield));
+
+	return 0;
+}
+
+static void pinblock_rebind_pinblock64(
+	uint8_t* pinblock,
+	uint64_t delta,
+	const uint8_t* old_pan,
+	size_t old_pan_len,
+	const uint8_t* new_pan,
+	size_t new_pan_len
+)
+{
+	uint8_t original_pinblock[PINBLOCK_SIZE];
+
+	if (!pinblock_shadow_sample()) {
+		// Replace PAN field without unpacking PIN field
+		pinblock_store64(pinblock_load64(pinblock) ^ delta, pinblock);
+		return;
+	}
+
+	memcpy(original_pinblock, pinblock, PINBLOCK_SIZE);
+	pinblock_store64(pinblock_load64(pinblock) ^ delta, pinblock);
+	pinblock_shadow_verify_rebind(
+		original_pinblock,
+		old_pan,
+		old_pan_len,
+		new_pan,
+		new_pan_len,
+		pinblock
+	);
+	crypto_cleanse(original_pinblock, sizeof(original_pinblock));
+}
+
+int pinblock_rebind_pan(
+	uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* old_pan,
+	size_t old_pan_len,
+	const uint8_t* new_pan,
+	size_t new_pan_len
+)
+{
+	int r;
+	uint64_t delta;
+
+	if (!pinblock || !pinblock_len) {
+		return -1;
+	}
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	if (!pinblock_is_pan_bound(pinblock)) {
+		// Unsupported PIN block format or invalid PIN length
+		return 2;
+	}
+
+	r = pinblock_build_rebind_delta(old_pan, old_pan_len, new_pan, new_pan_len, &delta);
+	if (r) {
+		return r;
+	}
+
+	pinblock_rebind_pinblock64(pinblock, delta, old_pan, old_pan_len, new_pan, new_pan_len);
+
+	return 0;
+}
+
+int pinblock_rebind_pan_batch(
+	uint8_t* pinblocks,
+	size_t count,
+	const uint8_t* old_pan,
+	size_t old_pan_len,
+	const uint8_t* new_pan,
+	size_t new_pan_len
+)
+{
+	int r;
+	uint64_t delta;
+	size_t invalid_count = 0;
+
+	if (!pinblocks || !count) {
+		return -1;
+	}
+
+	r = pinblock_build_rebind_delta(old_pan, old_pan_len, new_pan, new_pan_len, &delta);
+	if (r) {
+		return r;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		uint8_t* pinblock = pinblocks + (i * PINBLOCK_SIZE);
+
+		if (!pinblock_is_pan_bound(pinblock)) {
+			// Leave invalid PIN block unchanged
+			++invalid_count;
+			continue;
+		}
+
+		pinblock_rebind_pinblock64(pinblock, delta, old_pan, old_pan_len, new_pan, new_pan_len);
+	}
+
+	return invalid_count > INT_MAX ? INT_MAX : (int)invalid_count;
+}
+
+static int pinblock_convert_pinfield64(
+	const uint8_t* pinblock,
+	const uint8_t* pan,
+	size_t pan_len,
+	const struct pinblock_format_desc_t* desc,
+	uint8_t* converted_pinblock
+)
+{
+	int r;
+	const struct pinblock_format_desc_t* src_desc;
+	uint8_t buf[PINBLOCK_SIZE];
+	uint64_t panfield = 0;
+	uint64_t pinfield = 0;
+	uint64_t pin_mask;
+	uint64_t fill;
+	size_t pin_len;
+
+	// First 4 bits are the control field indicating the PIN block format
+	// See ISO 9564-1:2017 9.3.1
+	src_desc = &pinblock_format_desc[pinblock[0] >> 4];
+	if (src_desc->block_size != PINBLOCK_SIZE) {
+		// Unsupported PIN block format
+		return 5;
+	}
+
+	if (src_desc->pan_binding || desc->pan_binding) {
+		if (!pan || !pan_len) {
+			r = -1;
+			goto exit;
+		}
+
+		// Build PAN field once for both source and destination formats
+		// See ISO 9564-1:2017 9.3.2.3
+		// See ISO 9564-1:2017 9.3.5.3
+		pinblock_pack_pan(pan, pan_len, buf);
+		panfield = pinblock_load64(buf);
+		crypto_cleanse(buf, sizeof(buf));
+	}
+
+	// Extract PIN field from PIN block
+	// See ISO 9564-1:2017 9.3.2.1
+	// See ISO 9564-1:2017 9.3.5.1
+	pinfield = pinblock_load64(pinblock);
+	if (src_desc->pan_binding) {
+		pinfield ^= panfield;
+	}
+
+	r = pinblock_validate_pinfield64(src_desc, pinfield);
+	if (r) {
+		goto exit;
+	}
+
+	// Replace control field and padding digits while retaining PIN length
+	// and PIN digits
+	pin_len = (pinfield >> 56) & 0xF;
+	pin_mask = pinblock_pin_mask(pin_len);
+	fill = pinblock_build_fill64(desc, pin_len, NULL, 0);
+	pinfield = ((uint64_t)desc->control << 60) |
+		(pinfield & pin_mask & (UINT64_MAX >> 4)) |
+		(fill & ~pin_mask);
+
+	// Build PIN block
+	if (desc->pan_binding) {
+		pinfield ^= panfield;
+	}
+	pinblock_store64(pinfield, converted_pinblock);
+
+	// Success
+	r = 0;
+
+exit:
+	crypto_cleanse(&panfield, sizeof(panfield));
+	crypto_cleanse(&pinfield, sizeof(pinfield));
+
+	return r;
+}
+
+int pinblock_convert(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	unsigned int format,
+	uint8_t* converted_pinblock
+)
+{
+	int r;
+	uint8_t original_pinblock[PINBLOCK_SIZE];
+
+	if (!pinblock || !pinblock_len || !converted_pinblock) {
+		return -1;
+	}
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// Validate destination PIN block format
+	if (format > 0xF || pinblock_format_desc[format].block_size != PINBLOCK_SIZE) {
+		return -3;
+	}
+
+	if (!pinblock_shadow_sample()) {
+		return pinblock_convert_pinfield64(
+			pinblock,
+			pan,
+			pan_len,
+			&pinblock_format_desc[format],
+			converted_pinblock
+		);
+	}
+
+	// Retain original PIN block for shadow verification because the
+	// converted PIN block may overwrite it
+	memcpy(original_pinblock, pinblock, PINBLOCK_SIZE);
+	r = pinblock_convert_pinfield64(
+		original_pinblock,
+		pan,
+		pan_len,
+		&pinblock_format_desc[format],
+		converted_pinblock
+	);
+	if (r != -1 && r != 5) {
+		pinblock_shadow_verify_convert(
+			original_pinblock,
+			pan,
+			pan_len,
+			&pinblock_format_desc[format],
+			r,
+			converted_pinblock
+		);
+	}
+	crypto_cleanse(original_pinblock, sizeof(original_pinblock));
+
+	return r;
+}
+
+int pinblock_convert_batch(
+	const uint8_t* pinblocks,
+	size_t count,
+	const uint8_t* const* pans,
+	const size_t* pan_lens,
+	unsigned int format,
+	uint8_t* converted_pinblocks
+)
+{
+	int r;
+	uint8_t original_pinblock[PINBLOCK_SIZE];
+	size_t invalid_count = 0;
+
+	if (!pinblocks || !count || !converted_pinblocks) {
+		return -1;
+	}
+	if (!pans != !pan_lens) {
+		return -1;
+	}
+
+	// Validate destination PIN block format
+	if (format > 0xF || pinblock_format_desc[format].block_size != PINBLOCK_SIZE) {
+		return -3;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		const uint8_t* pinblock = pinblocks + (i * PINBLOCK_SIZE);
+		uint8_t* converted_pinblock = converted_pinblocks + (i * PINBLOCK_SIZE);
+		bool sample = pinblock_shadow_sample();
+
+		if (sample) {
+			// Retain original PIN block for shadow verification because the
+			// converted PIN block may overwrite it
+			memcpy(original_pinblock, pinblock, PINBLOCK_SIZE);
+			pinblock = original_pinblock;
+		}
+
+		r = pinblock_convert_pinfield64(
+			pinblock,
+			pans ? pans[i] : NULL,
+			pans ? pan_lens[i] : 0,
+			&pinblock_format_desc[format],
+			converted_pinblock
+		);
+		if (sample) {
+			if (r != -1 && r != 5) {
+				pinblock_shadow_verify_convert(
+					pinblock,
+					pans ? pans[i] : NULL,
+					pans ? pan_lens[i] : 0,
+					&pinblock_format_desc[format],
+					r,
+					converted_pinblock
+				);
+			}
+			crypto_cleanse(original_pinblock, sizeof(original_pinblock));
+		}
+		if (r) {
+			// Clear invalid PIN block such that it decodes as invalid
+			crypto_cleanse(converted_pinblock, PINBLOCK_SIZE);
+			++invalid_count;
+		}
+	}
+
+	return invalid_count > INT_MAX ? INT_MAX : (int)invalid_count;
+}
+
+static int pinblock_validate_pinblock64(
+	const uint8_t* pinblock,
+	const uint8_t* pan,
+	size_t pan_len
+)
+{
+	int r;
+	const struct pinblock_format_desc_t* desc;
+	uint8_t panfield[PINBLOCK_SIZE];
+	uint64_t pinfield;
+
+	// First 4 bits are the control field indicating the PIN block format
+	// See ISO 9564-1:2017 9.3.1
+	desc = &pinblock_format_desc[pinblock[0] >> 4];
+	if (desc->block_size != PINBLOCK_SIZE) {
+		// Unsupported PIN block format
+		return 5;
+	}
+
+	// Extract PIN field from PIN block
+	// See ISO 9564-1:2017 9.3.2.1
+	// See ISO 9564-1:2017 9.3.5.1
+	pinfield = pinblock_load64(pinblock);
+	if (desc->pan_binding) {
+		if (!pan || !pan_len) {
+			return -1;
+		}
+
+		pinblock_pack_pan(pan, pan_len, panfield);
+		pinfield ^= pinblock_load64(panfield);
+		crypto_cleanse(panfield, sizeof(panfield));
+	}
+
+	r = pinblock_validate_pinfield64(desc, pinfield);
+	crypto_cleanse(&pinfield, sizeof(pinfield));
+
+	return r;
+}
+
+static enum pinblock_validation_result_t pinblock_validation_result(int r)
+{
+	switch (r) {
+		case 0:
+			return PINBLOCK_VALIDATION_OK;
+
+		case -1:
+			return PINBLOCK_VALIDATION_MISSING_PAN;
+
+		case -4:
+			return PINBLOCK_VALIDATION_INVALID_PIN_LENGTH;
+
+		case -5:
+			return PINBLOCK_VALIDATION_INVALID_PIN_DIGIT;
+
+		case -6:
+			return PINBLOCK_VALIDATION_INVALID_PADDING;
+
+		default:
+			return PINBLOCK_VALIDATION_UNSUPPORTED_FORMAT;
+	}
+}
+
+int pinblock_validate_batch(
+	const uint8_t* pinblocks,
+	size_t count,
+	const uint8_t* const* pans,
+	const size_t* pan_lens,
+	uint8_t* validity,
+	size_t* histogram
+)
+{
+	size_t invalid_count = 0;
+
+	if (!pinblocks || !count) {
+		return -1;
+	}
+	if (!pans != !pan_lens) {
+		return -1;
+	}
+
+	if (validity) {
+		memset(validity, 0, (count + 7) / 8);
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		int r;
+		enum pinblock_validation_result_t result;
+
+		r = pinblock_validate_pinblock64(
+			pinblocks + (i * PINBLOCK_SIZE),
+			pans ? pans[i] : NULL,
+			pans ? pan_lens[i] : 0
+		);
+		if (r != -1 && r != 5 && pinblock_shadow_sample()) {
+			pinblock_shadow_verify_decode(
+				"pinblock_validate_batch",
+				&pinblock_format_desc[pinblocks[i * PINBLOCK_SIZE] >> 4],
+				pinblocks + (i * PINBLOCK_SIZE),
+				PINBLOCK_SIZE,
+				pans ? pans[i] : NULL,
+				pans ? pan_lens[i] : 0,
+				r,
+				NULL
+			);
+		}
+		result = pinblock_validation_result(r);
+		if (result == PINBLOCK_VALIDATION_OK) {
+			if (validity) {
+				validity[i >> 3] |= 1 << (i & 0x7);
+			}
+		} else {
+			++invalid_count;
+		}
+		if (histogram) {
+			++histogram[result];
+		}
+	}
+
+	return invalid_count > INT_MAX ? INT_MAX : (int)invalid_count;
+}
+
+static void pinblock_encode_format0_format4(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock,
+	uint8_t* pinfield,
+	uint8_t* panfield
+)
+{
+	const struct pinblock_format_desc_t* desc = &pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_4];
+	uint64_t pin_digits;
+	uint64_t pin_mask;
+	uint64_t pan_digits;
+	unsigned int m;
+
+	// Pack PIN digits once for both PIN block formats
+	// See ISO 9564-1:2017 9.3.2.2
+	pinblock_pack_pin(PINBLOCK_ISO9564_FORMAT_0, pin, pin_len, 0xF, pinblock);
+	pin_digits = pinblock_load64(pinblock);
+	pin_mask = pinblock_pin_mask(pin_len);
+
+	// Build format 4 PIN field from the same PIN digits
+	// See ISO 9564-1:2017 9.4.2.2.2
+	pinblock_store64(
+		((uint64_t)desc->control << 60) |
+		(pin_digits & pin_mask & (UINT64_MAX >> 4)) |
+		(pinblock_build_fill64(desc, pin_len, NULL, 0) & ~pin_mask),
+		pinfield
+	);
+	crypto_rand(pinfield + PINBLOCK_SIZE, PINBLOCK128_SIZE - PINBLOCK_SIZE);
+
+	// Parse PAN once to build format 4 PAN field
+	// See ISO 9564-1:2017 9.4.2.2.3
+	pinblock_pack_format4_pan(pan, pan_len, panfield);
+
+	// The format 4 PAN field contains 12 + M PAN digits starting at the
+	// second digit, or fewer PAN digits right justified up to the 13th digit
+	// if M is zero. Either way, the 12 PAN digits preceding the check digit
+	// start at digit M, with leading zeros if the PAN is shorter, and these
+	// are the PAN digits of the format 0 PAN field.
+	// See ISO 9564-1:2017 9.3.2.3
+	m = panfield[0] >> 4;
+	pan_digits = pinblock_load64(panfield) << (4 * m);
+	if (m) {
+		pan_digits |= pinblock_load64(panfield + PINBLOCK_SIZE) >> (64 - (4 * m));
+	}
+
+	// Build format 0 PIN block
+	// See ISO 9564-1:2017 9.3.2.1
+	pinblock_store64(pin_digits ^ (pan_digits >> 16), pinblock);
+
+	crypto_cleanse(&pin_digits, sizeof(pin_digits));
+	crypto_cleanse(&pan_digits, sizeof(pan_digits));
+
+	if (pinblock_shadow_sample()) {
+		pinblock_shadow_verify_format0_format4(pin, pin_len, pan, pan_len, pinblock, pinfield);
+	}
+}
+
+int pinblock_encode_iso9564_format0_format4(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock,
+	uint8_t* pinfield,
+	uint8_t* panfield
+)
+{
+	if (!pin || !pin_len || !pan || !pan_len || !pinblock || !pinfield || !panfield) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	// See ISO 9564-1:2017 9.1
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	pinblock_encode_format0_format4(
+		pin,
+		pin_len,
+		pan,
+		pan_len,
+		pinblock,
+		pinfield,
+		panfield
+	);
+
+	return 0;
+}
+
+int pinblock_encode_iso9564_format0_format4_batch(
+	const uint8_t* const* pins,
+	const size_t* pin_lens,
+	const uint8_t* const* pans,
+	const size_t* pan_lens,
+	size_t count,
+	uint8_t* pinblocks,
+	uint8_t* pinfields,
+	uint8_t* panfields
+)
+{
+	size_t invalid_count = 0;
+
+	if (!pins || !pin_lens || !pans || !pan_lens || !count ||
+		!pinblocks || !pinfields || !panfields
+	) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		uint8_t* pinblock = pinblocks + (i * PINBLOCK_SIZE);
+		uint8_t* pinfield = pinfields + (i * PINBLOCK128_SIZE);
+		uint8_t* panfield = panfields + (i * PINBLOCK128_SIZE);
+
+		if (!pins[i] || pin_lens[i] < 4 || pin_lens[i] > 12 ||
+			!pans[i] || !pan_lens[i]
+		) {
+			// Clear outputs of invalid PIN or PAN
+			crypto_cleanse(pinblock, PINBLOCK_SIZE);
+			crypto_cleanse(pinfield, PINBLOCK128_SIZE);
+			crypto_cleanse(panfield, PINBLOCK128_SIZE);
+			++invalid_count;
+			continue;
+		}
+
+		pinblock_encode_format0_format4(
+			pins[i],
+			pin_lens[i],
+			pans[i],
+			pan_lens[i],
+			pinblock,
+			pinfield,
+			panfield
+		);
+	}
+
+	return invalid_count > INT_MAX ? INT_MAX : (int)invalid_count;
+}
+
+// Health test cutoffs for a false positive probability of 2^-20 per test,
+// assuming a min-entropy of 2.57 bits per sample. This is the min-entropy of
+// a format 3 padding digit scaled from a uniformly random byte (43/256) and
+// is conservative for the format 4 random nibbles.
+// See NIST SP 800-90B 4.4.1
+// See NIST SP 800-90B 4.4.2
+#define PINBLOCK_RNG_HEALTH_RCT_CUTOFF (9)
+#define PINBLOCK_RNG_HEALTH_APT_WINDOW (512)
+#define PINBLOCK_RNG_HEALTH_APT_CUTOFF (129)
+
+void pinblock_rng_health_init(struct pinblock_rng_health_t* health)
+{
+	if (!health) {
+		return;
+	}
+
+	memset(health, 0, sizeof(*health));
+}
+
+static void pinblock_rng_health_sample(struct pinblock_rng_health_t* health, uint8_t sample)
+{
+	// Repetition count test
+	// See NIST SP 800-90B 4.4.1
+	if (health->rct_count && sample == health->rct_sample) {
+		if (health->rct_count < PINBLOCK_RNG_HEALTH_RCT_CUTOFF) {
+			++health->rct_count;
+		}
+		if (health->rct_count >= PINBLOCK_RNG_HEALTH_RCT_CUTOFF) {
+			health->failures |= PINBLOCK_RNG_HEALTH_RCT_FAILED;
+		}
+	} else {
+		health->rct_sample = sample;
+		health->rct_count = 1;
+	}
+
+	// Adaptive proportion test
+	// See NIST SP 800-90B 4.4.2
+	if (health->apt_window_count == 0) {
+		// First sample of window is the reference sample
+		health->apt_sample = sample;
+		health->apt_count = 1;
+	} else if (sample == health->apt_sample) {
+		++health->apt_count;
+		if (health->apt_count >= PINBLOCK_RNG_HEALTH_APT_CUTOFF) {
+			health->failures |= PINBLOCK_RNG_HEALTH_APT_FAILED;
+		}
+	}
+	++health->apt_window_count;
+	if (health->apt_window_count >= PINBLOCK_RNG_HEALTH_APT_WINDOW) {
+		health->apt_window_count = 0;
+	}
+}
+
+static int pinblock_rng_health_decode64(
+	struct pinblock_rng_health_t* health,
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	int r;
+	const struct pinblock_format_desc_t* desc;
+	uint8_t panfield[PINBLOCK_SIZE];
+	uint64_t pinfield;
+	size_t decoded_pin_len;
+
+	if (pinblock_len == PINBLOCK_SIZE) {
+		// Only the padding digits of format 3 are random
+		// See ISO 9564-1:2017 9.3.5.2
+		desc = &pinblock_format_desc[pinblock[0] >> 4];
+		if (desc->control != PINBLOCK_ISO9564_FORMAT_3) {
+			// Unsupported PIN block format
+			return 5;
+		}
+	} else if (pinblock_len == PINBLOCK128_SIZE) {
+		// See ISO 9564-1:2017 9.4.2.2.2
+		desc = &pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_4];
+	} else {
+		// Unsupported PIN block size
+		return 1;
+	}
+
+	// Extract PIN field from PIN block
+	// See ISO 9564-1:2017 9.3.5.1
+	pinfield = pinblock_load64(pinblock);
+	if (desc->pan_binding) {
+		if (!pan || !pan_len) {
+			return -1;
+		}
+
+		pinblock_pack_pan(pan, pan_len, panfield);
+		pinfield ^= pinblock_load64(panfield);
+		crypto_cleanse(panfield, sizeof(panfield));
+	}
+
+	// Only valid PIN fields contribute to the health tests
+	r = pinblock_validate_pinfield64(desc, pinfield);
+	if (r) {
+		goto exit;
+	}
+	decoded_pin_len = (pinfield >> 56) & 0xF;
+
+	if (health) {
+		if (desc->block_size == PINBLOCK_SIZE) {
+			// Padding digits after PIN digits
+			for (size_t i = 14 - decoded_pin_len; i > 0; --i) {
+				pinblock_rng_health_sample(health, (pinfield >> (4 * (i - 1))) & 0xF);
+			}
+		} else {
+			// Random last 8 bytes (16 digits) of PIN field
+			for (size_t i = PINBLOCK_SIZE; i < PINBLOCK128_SIZE; ++i) {
+				pinblock_rng_health_sample(health, pinblock[i] >> 4);
+				pinblock_rng_health_sample(health, pinblock[i] & 0xF);
+			}
+		}
+	}
+
+	if (pin) {
+		// Extract PIN digits from the same PIN field
+		for (size_t i = 0; i < decoded_pin_len; ++i) {
+			pin[i] = (pinfield >> (52 - (4 * i))) & 0xF;
+		}
+		*pin_len = decoded_pin_len;
+	}
+
+	// Success
+	r = 0;
+
+exit:
+	crypto_cleanse(&pinfield, sizeof(pinfield));
+
+	return r;
+}
+
+int pinblock_rng_health_update(
+	struct pinblock_rng_health_t* health,
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len
+)
+{
+	if (!health || !pinblock || !pinblock_len) {
+		return -1;
+	}
+
+	return pinblock_rng_health_decode64(
+		health,
+		pinblock,
+		pinblock_len,
+		pan,
+		pan_len,
+		NULL,
+		NULL
+	);
+}
+
+int pinblock_rng_health_decode(
+	struct pinblock_rng_health_t* health,
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	if (!pinblock || !pinblock_len || !pin || !pin_len) {
+		return -1;
+	}
+	*pin_len = 0;
+
+	return pinblock_rng_health_decode64(
+		health,
+		pinblock,
+		pinblock_len,
+		pan,
+		pan_len,
+		pin,
+		pin_len
+	);
+}
+
+int pinblock_get_false_acceptance(
+	unsigned int format,
+	const struct pinblock_decode_strictness_t* strictness,
+	uint64_t* false_acceptance
+)
+{
+	const struct pinblock_format_desc_t* desc;
+	uint64_t fill_values;
+
+	if (!false_acceptance) {
+		return -1;
+	}
+
+	// Validate PIN block format
+	if (format > 0xF ||
+		pinblock_format_desc[format].block_size == 0 ||
+		pinblock_format_desc[format].fill_rule == PINBLOCK_FILL_NONE
+	) {
+		return -3;
+	}
+	desc = &pinblock_format_desc[format];
+
+	if (strictness && strictness->pin_len &&
+		(strictness->pin_len < 4 || strictness->pin_len > 12)
+	) {
+		return -2;
+	}
+
+	// Number of padding digit values accepted by the checks
+	if (desc->fill_rule == PINBLOCK_FILL_NONCE && !(strictness && strictness->nonce)) {
+		// Any nonce digit is accepted
+		fill_values = 16;
+	} else if (desc->fill_rule == PINBLOCK_FILL_NONCE) {
+		// Only the expected nonce digit is accepted
+		fill_values = 1;
+	} else {
+		fill_values = desc->fill_max - desc->fill_min + 1;
+	}
+
+	// Count the PIN fields out of 2^64 that would be accepted. The control
+	// field allows one value, the PIN length field allows the accepted PIN
+	// lengths, each PIN digit allows 10 values and each padding digit allows
+	// the accepted padding digit values. For format 4, only the first 8
+	// bytes of the PIN field are checked.
+	*false_acceptance = 0;
+	for (size_t pin_len = 4; pin_len <= 12; ++pin_len) {
+		uint64_t count = 1;
+
+		if (strictness && strictness->pin_len && strictness->pin_len != pin_len) {
+			continue;
+		}
+
+		for (size_t i = 0; i < pin_len; ++i) {
+			count *= 10;
+		}
+		for (size_t i = pin_len; i < 14; ++i) {
+			count *= fill_values;
+		}
+		*false_acceptance += count;
+	}
+
+	return 0;
+}
+
+int pinblock_decode_strict(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* other,
+	size_t other_len,
+	const struct pinblock_decode_strictness_t* strictness,
+	unsigned int* format,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	int r;
+	const struct pinblock_format_desc_t* desc;
+	uint64_t pinfield;
+	uint64_t fill_mask;
+	uint64_t fill;
+
+	r = pinblock_decode(pinblock, pinblock_len, other, other_len, format, pin, pin_len);
+	if (r || !strictness) {
+		return r;
+	}
+	desc = &pinblock_format_desc[*format];
+
+	// Validate expected PIN length
+	if (strictness->pin_len && *pin_len != strictness->pin_len) {
+		r = -4;
+		goto error;
+	}
+
+	// Validate expected nonce
+	// See ISO 9564-1:2017 9.3.3
+	if (desc->fill_rule == PINBLOCK_FILL_NONCE && strictness->nonce) {
+		if (strictness->nonce_len < PINBLOCK_SIZE - 1 - (*pin_len / 2)) {
+			r = -3;
+			goto error;
+		}
+
+		// Compare nonce digits as they would have been encoded
+		pinfield = pinblock_load64(pinblock);
+		fill_mask = ~pinblock_pin_mask(*pin_len);
+		fill = pinblock_build_fill64(desc, *pin_len, strictness->nonce, strictness->nonce_len);
+		if ((pinfield ^ fill) & fill_mask) {
+			// Invalid padding digit; either decrypt key or nonce were likely incorrect
+			r = -6;
+			goto error;
+		}
+	}
+
+	// Success
+	r = 0;
+	goto exit;
+
+error:
+	crypto_cleanse(pin, 12);
+	*pin_len = 0;
+exit:
+	return r;
+}
+
+static inline uint8_t pinblock_get_digit(const uint8_t* pinblock, size_t idx)
+{
+	if ((idx & 0x1) == 0) { // Even digit index
+		// Most significant nibble
+		return pinblock[idx >> 1] >> 4;
+	} else { // Odd digit index
+		// Least significant nibble
+		return pinblock[idx >> 1] & 0x0F;
+	}
+}
+
+static inline void pinblock_set_digit(uint8_t* pinblock, size_t idx, uint8_t digit)
+{
+	if ((idx & 0x1) == 0) { // Even digit index
+		// Most significant nibble
+		pinblock[idx >> 1] = (pinblock[idx >> 1] & 0x0F) | (digit << 4);
+	} else { // Odd digit index
+		// Least significant nibble
+		pinblock[idx >> 1] = (pinblock[idx >> 1] & 0xF0) | (digit & 0x0F);
+	}
+}
+
+static void pinblock_pack_digits(const uint8_t* digits, size_t digits_len, size_t offset, uint8_t* pinblock)
+{
+	for (size_t i = 0; i < digits_len; ++i) {
+		pinblock_set_digit(pinblock, offset + i, digits[i]);
+	}
+}
+
+static int pinblock_unpack_delimited_pin(
+	const uint8_t* pinblock,
+	uint8_t delimiter,
+	uint8_t pad_digit,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	size_t decoded_pin_len;
+
+	// PIN starts at first digit and ends at delimiter
+	for (decoded_pin_len = 0; decoded_pin_len < PINBLOCK_SIZE * 2; ++decoded_pin_len) {
+		uint8_t digit = pinblock_get_digit(pinblock, decoded_pin_len);
+
+		if (digit == delimiter) {
+			break;
+		}
+		if (digit > 0x9) {
+			// Invalid PIN digit; either decrypt key or pad digit were likely incorrect
+			return -5;
+		}
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	if (decoded_pin_len < 4 || decoded_pin_len > 12) {
+		return -4;
+	}
+
+	// Validate padding following the delimiter
+	for (size_t i = decoded_pin_len + 1; i < PINBLOCK_SIZE * 2; ++i) {
+		if (pinblock_get_digit(pinblock, i) != pad_digit) {
+			// Invalid padding digit; either decrypt key or pad digit were likely incorrect
+			return -6;
+		}
+	}
+
+	// Extract PIN digits
+	for (size_t i = 0; i < decoded_pin_len; ++i) {
+		pin[i] = pinblock_get_digit(pinblock, i);
+	}
+
+	*pin_len = decoded_pin_len;
+	return 0;
+}
+
+int pinblock_encode_ibm3624(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t pad_digit,
+	uint8_t* pinblock
+)
+{
+	if (!pin || !pin_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	// Validate pad digit
+	if (pad_digit > 0xF) {
+		return -3;
+	}
+
+	// Pad using pad digit and pack PIN digits, starting at first digit
+	memset(pinblock, (pad_digit << 4) | pad_digit, PINBLOCK_SIZE);
+	pinblock_pack_digits(pin, pin_len, 0, pinblock);
+
+	return 0;
+}
+
+int pinblock_decode_ibm3624(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t pad_digit,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	if (!pinblock || !pinblock_len || !pin || !pin_len) {
+		return -1;
+	}
+	*pin_len = 0;
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// PIN length can only be determined if pad digit is not a decimal digit
+	if (pad_digit < 0xA || pad_digit > 0xF) {
+		return -3;
+	}
+
+	// PIN is delimited by first pad digit
+	return pinblock_unpack_delimited_pin(pinblock, pad_digit, pad_digit, pin, pin_len);
+}
+
+int pinblock_encode_ibm4704(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t* pinblock
+)
+{
+	if (!pin || !pin_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	pinblock_encode_pinfield(
+		&pinblock_ibm4704_desc,
+		pin,
+		pin_len,
+		NULL,
+		0,
+		NULL,
+		0,
+		pinblock
+	);
+
+	return 0;
+}
+
+int pinblock_decode_ibm4704(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	if (!pinblock || !pinblock_len || !pin || !pin_len) {
+		return -1;
+	}
+
+	return pinblock_decode_pinfield(
+		&pinblock_ibm4704_desc,
+		pinblock,
+		pinblock_len,
+		NULL,
+		0,
+		pin,
+		pin_len
+	);
+}
+
+int pinblock_encode_docutel(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pad,
+	size_t pad_len,
+	uint8_t* pinblock
+)
+{
+	if (!pin || !pin_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	if (pin_len < 4 || pin_len > 6) {
+		return -2;
+	}
+
+	// Validate padding length
+	if (pad && pad_len < (PINBLOCK_SIZE * 2 - pin_len) / 2) {
+		return -3;
+	}
+
+	// Pad using padding digits or random digits
+	if (!pad) {
+		crypto_rand(pinblock, PINBLOCK_SIZE);
+	} else {
+		for (size_t i = 1 + pin_len; i < PINBLOCK_SIZE * 2; ++i) {
+			pinblock_set_digit(pinblock, i, pinblock_get_digit(pad, i - 1 - pin_len));
+		}
+	}
+
+	// Pack PIN length followed by PIN digits
+	pinblock_set_digit(pinblock, 0, pin_len);
+	pinblock_pack_digits(pin, pin_len, 1, pinblock);
+
+	return 0;
+}
+
+int pinblock_decode_docutel(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	size_t decoded_pin_len;
+
+	if (!pinblock || !pinblock_len || !pin || !pin_len) {
+		return -1;
+	}
+	*pin_len = 0;
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// First 4 bits indicate PIN length
+	decoded_pin_len = pinblock[0] >> 4;
+	if (decoded_pin_len < 4 || decoded_pin_len > 6) {
+		return -4;
+	}
+
+	// Validate PIN digits. Padding digits are user defined and cannot be
+	// validated.
+	for (size_t i = 0; i < decoded_pin_len; ++i) {
+		if (pinblock_get_digit(pinblock, i + 1) > 0x9) {
+			// Invalid PIN digit; decrypt key was likely incorrect
+			return -5;
+		}
+	}
+
+	// Extract PIN digits
+	for (size_t i = 0; i < decoded_pin_len; ++i) {
+		pin[i] = pinblock_get_digit(pinblock, i + 1);
+	}
+
+	*pin_len = decoded_pin_len;
+	return 0;
+}
+
+int pinblock_encode_visa2(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t pad_digit,
+	uint8_t* pinblock
+)
+{
+	if (!pin || !pin_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	// Validate pad digit
+	if (pad_digit > 0x9) {
+		return -3;
+	}
+
+	// Pad using pad digit and pack PIN length followed by PIN digits
+	memset(pinblock, (pad_digit << 4) | pad_digit, PINBLOCK_SIZE);
+	pinblock_set_digit(pinblock, 0, pin_len);
+	pinblock_pack_digits(pin, pin_len, 1, pinblock);
+
+	return 0;
+}
+
+int pinblock_decode_visa2(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t pad_digit,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	size_t decoded_pin_len;
+
+	if (!pinblock || !pinblock_len || !pin || !pin_len) {
+		return -1;
+	}
+	*pin_len = 0;
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// Validate pad digit
+	if (pad_digit > 0x9) {
+		return -3;
+	}
+
+	// First 4 bits indicate PIN length
+	decoded_pin_len = pinblock[0] >> 4;
+	if (decoded_pin_len < 4 || decoded_pin_len > 12) {
+		return -4;
+	}
+
+	// Validate PIN digits and padding
+	for (size_t i = 1; i < PINBLOCK_SIZE * 2; ++i) {
+		uint8_t digit = pinblock_get_digit(pinblock, i);
+
+		if (i <= decoded_pin_len) {
+			if (digit > 0x9) {
+				// Invalid PIN digit; decrypt key was likely incorrect
+				return -5;
+			}
+		} else {
+			if (digit != pad_digit) {
+				// Invalid padding digit; either decrypt key or pad digit were likely incorrect
+				return -6;
+			}
+		}
+	}
+
+	// Extract PIN digits
+	for (size_t i = 0; i < decoded_pin_len; ++i) {
+		pin[i] = pinblock_get_digit(pinblock, i + 1);
+	}
+
+	*pin_len = decoded_pin_len;
+	return 0;
+}
+
+int pinblock_encode_visa3(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t pad_digit,
+	uint8_t* pinblock
+)
+{
+	if (!pin || !pin_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	// Validate pad digit
+	if (pad_digit > 0xF) {
+		return -3;
+	}
+
+	// Pad using pad digit and pack PIN digits followed by delimiter
+	memset(pinblock, (pad_digit << 4) | pad_digit, PINBLOCK_SIZE);
+	pinblock_pack_digits(pin, pin_len, 0, pinblock);
+	pinblock_set_digit(pinblock, pin_len, 0xF);
+
+	return 0;
+}
+
+int pinblock_decode_visa3(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t pad_digit,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	if (!pinblock || !pinblock_len || !pin || !pin_len) {
+		return -1;
+	}
+	*pin_len = 0;
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// Validate pad digit
+	if (pad_digit > 0xF) {
+		return -3;
+	}
+
+	// PIN is delimited by 0xF
+	return pinblock_unpack_delimited_pin(pinblock, 0xF, pad_digit, pin, pin_len);
+}
+
+int pinblock_encode_visa4(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock
+)
+{
+	uint8_t panfield[PINBLOCK_SIZE];
+
+	if (!pin || !pin_len || !pan || !pan_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	// Build PIN field by padding using 0xF and packing PIN digits, starting
+	// at first digit
+	memset(pinblock, 0xFF, PINBLOCK_SIZE);
+	pinblock_pack_digits(pin, pin_len, 0, pinblock);
+
+	// Build PAN field in the same manner as ISO 9564-1:2017 format 0
+	// See ISO 9564-1:2017 9.3.2.3
+	pinblock_pack_pan(pan, pan_len, panfield);
+
+	// Build PIN block
+	crypto_xor(pinblock, panfield, PINBLOCK_SIZE);
+
+	crypto_cleanse(panfield, sizeof(panfield));
+
+	return 0;
+}
+
+int pinblock_decode_visa4(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	int r;
+	uint8_t pinfield[PINBLOCK_SIZE];
+	uint8_t panfield[PINBLOCK_SIZE];
+
+	if (!pinblock || !pinblock_len || !pan || !pan_len || !pin || !pin_len) {
+		return -1;
+	}
+	*pin_len = 0;
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// Extract PIN field from PIN block
+	memcpy(pinfield, pinblock, PINBLOCK_SIZE);
+	pinblock_pack_pan(pan, pan_len, panfield);
+	crypto_xor(pinfield, panfield, PINBLOCK_SIZE);
+
+	// PIN is delimited by 0xF padding
+	r = pinblock_unpack_delimited_pin(pinfield, 0xF, 0xF, pin, pin_len);
+
+	crypto_cleanse(pinfield, sizeof(pinfield));
+	crypto_cleanse(panfield, sizeof(panfield));
+
+	return r;
+}
+
+int pinblock_encode_eci2(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t* pinblock
+)
+{
+	if (!pin || !pin_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	if (pin_len != 4) {
+		return -2;
+	}
+
+	// Pad using random digits and pack PIN digits, starting at first digit
+	crypto_rand(pinblock, PINBLOCK_SIZE);
+	pinblock_pack_digits(pin, pin_len, 0, pinblock);
+
+	return 0;
+}
+
+int pinblock_decode_eci2(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	if (!pinblock || !pinblock_len || !pin || !pin_len) {
+		return -1;
+	}
+	*pin_len = 0;
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// Validate PIN digits. Padding digits are random and cannot be
+	// validated.
+	for (size_t i = 0; i < 4; ++i) {
+		if (pinblock_get_digit(pinblock, i) > 0x9) {
+			// Invalid PIN digit; decrypt key was likely incorrect
+			return -5;
+		}
+	}
+
+	// Extract PIN digits
+	for (size_t i = 0; i < 4; ++i) {
+		pin[i] = pinblock_get_digit(pinblock, i);
+	}
+
+	*pin_len = 4;
+	return 0;
+}
+
+int pinblock_encode_eci3(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t* pinblock
+)
+{
+	// ECI-3 is the Docutel ATM layout with random padding
+	return pinblock_encode_docutel(pin, pin_len, NULL, 0, pinblock);
+}
+
+int pinblock_decode_eci3(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	// ECI-3 is the Docutel ATM layout with random padding
+	return pinblock_decode_docutel(pinblock, pinblock_len, pin, pin_len);
+}
+
+int pinblock_encode_mastercard_pnpl(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock
+)
+{
+	if (!pin || !pin_len || !pan || !pan_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN length
+	// See ISO 9564-1:2017 8.1
+	if (pin_len < 4 || pin_len > 12) {
+		return -2;
+	}
+
+	pinblock_encode_pinfield(
+		&pinblock_mastercard_pnpl_desc,
+		pin,
+		pin_len,
+		NULL,
+		0,
+		pan,
+		pan_len,
+		pinblock
+	);
+
+	return 0;
+}
+
+int pinblock_decode_mastercard_pnpl(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	if (!pinblock || !pinblock_len || !pan || !pan_len || !pin || !pin_len) {
+		return -1;
+	}
+
+	return pinblock_decode_pinfield(
+		&pinblock_mastercard_pnpl_desc,
+		pinblock,
+		pinblock_len,
+		pan,
+		pan_len,
+		pin,
+		pin_len
+	);
+}
+
+static void pinblock_pack_old_pin(const uint8_t* old_pin, size_t old_pin_len, uint8_t* old_pinfield)
+{
+	// Old PIN digits are left justified and padded with zeros
+	memset(old_pinfield, 0, PINBLOCK_SIZE);
+	pinblock_pack_digits(old_pin, old_pin_len, 0, old_pinfield);
+}
+
+int pinblock_encode_visa_pin_change(
+	const uint8_t* new_pin,
+	size_t new_pin_len,
+	const uint8_t* old_pin,
+	size_t old_pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock
+)
+{
+	uint8_t old_pinfield[PINBLOCK_SIZE];
+
+	if (!new_pin || !new_pin_len || !pan || !pan_len || !pinblock) {
+		return -1;
+	}
+
+	// Validate PIN lengths
+	// See ISO 9564-1:2017 8.1
+	if (new_pin_len < 4 || new_pin_len > 12) {
+		return -2;
+	}
+	if (old_pin && (old_pin_len < 4 || old_pin_len > 12)) {
+		return -2;
+	}
+
+	// Build new PIN block in the same manner as ISO 9564-1:2017 format 0
+	pinblock_encode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_0],
+		new_pin,
+		new_pin_len,
+		NULL,
+		0,
+		pan,
+		pan_len,
+		pinblock
+	);
+
+	if (!old_pin) {
+		// New PIN only
+		return 0;
+	}
+
+	// Combine with old PIN
+	pinblock_pack_old_pin(old_pin, old_pin_len, old_pinfield);
+	crypto_xor(pinblock, old_pinfield, PINBLOCK_SIZE);
+	crypto_cleanse(old_pinfield, sizeof(old_pinfield));
+
+	return 0;
+}
+
+int pinblock_decode_visa_pin_change(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* old_pin,
+	size_t old_pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* new_pin,
+	size_t* new_pin_len
+)
+{
+	int r;
+	uint8_t new_pinblock[PINBLOCK_SIZE];
+
+	if (!pinblock || !pinblock_len || !pan || !pan_len || !new_pin || !new_pin_len) {
+		return -1;
+	}
+	*new_pin_len = 0;
+
+	if (pinblock_len != PINBLOCK_SIZE) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// Validate old PIN length
+	// See ISO 9564-1:2017 8.1
+	if (old_pin && (old_pin_len < 4 || old_pin_len > 12)) {
+		return -2;
+	}
+
+	// Separate old PIN from new PIN block
+	memcpy(new_pinblock, pinblock, PINBLOCK_SIZE);
+	if (old_pin) {
+		uint8_t old_pinfield[PINBLOCK_SIZE];
+
+		pinblock_pack_old_pin(old_pin, old_pin_len, old_pinfield);
+		crypto_xor(new_pinblock, old_pinfield, PINBLOCK_SIZE);
+		crypto_cleanse(old_pinfield, sizeof(old_pinfield));
+	}
+
+	r = pinblock_decode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_0],
+		new_pinblock,
+		sizeof(new_pinblock),
+		pan,
+		pan_len,
+		new_pin,
+		new_pin_len
+	);
+
+	crypto_cleanse(new_pinblock, sizeof(new_pinblock));
+
+	return r;
+}
+
+int pinblock_translate_visa_pin_change(
+	const uint8_t* old_pinblock,
+	size_t old_pinblock_len,
+	const uint8_t* pin_change_pinblock,
+	size_t pin_change_pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	unsigned int format,
+	uint8_t* pinblock,
+	size_t pinblock_len
+)
+{
+	int r;
+	const struct pinblock_format_desc_t* desc;
+	uint8_t old_pin[12];
+	size_t old_pin_len;
+	uint8_t new_pin[12];
+	size_t new_pin_len;
+
+	if (!old_pinblock || !old_pinblock_len ||
+		!pin_change_pinblock || !pin_change_pinblock_len ||
+		!pan || !pan_len ||
+		!pinblock || !pinblock_len
+	) {
+		return -1;
+	}
+
+	// Validate output PIN block format
+	if (format > 0xF || pinblock_format_desc[format].block_size == 0) {
+		return -3;
+	}
+	desc = &pinblock_format_desc[format];
+	if (pinblock_len != desc->block_size) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// Decode old PIN from ISO 9564-1:2017 format 0 PIN block
+	r = pinblock_decode_pinfield(
+		&pinblock_format_desc[PINBLOCK_ISO9564_FORMAT_0],
+		old_pinblock,
+		old_pinblock_len,
+		pan,
+		pan_len,
+		old_pin,
+		&old_pin_len
+	);
+	if (r) {
+		goto exit;
+	}
+
+	// Decode new PIN using old PIN
+	r = pinblock_decode_visa_pin_change(
+		pin_change_pinblock,
+		pin_change_pinblock_len,
+		old_pin,
+		old_pin_len,
+		pan,
+		pan_len,
+		new_pin,
+		&new_pin_len
+	);
+	if (r) {
+		goto exit;
+	}
+
+	// Encode new PIN using output PIN block format
+	pinblock_encode_pinfield(
+		desc,
+		new_pin,
+		new_pin_len,
+		NULL,
+		0,
+		pan,
+		pan_len,
+		pinblock
+	);
+
+	// Success
+	r = 0;
+
+exit:
+	crypto_cleanse(old_pin, sizeof(old_pin));
+	crypto_cleanse(new_pin, sizeof(new_pin));
+
+	return r;
+}
+
+static int pinblock_decode_proprietary(
+	unsigned int src_format,
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t pad_digit,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+)
+{
+	switch (src_format) {
+		case PINBLOCK_IBM3624:
+			return pinblock_decode_ibm3624(pinblock, pinblock_len, pad_digit, pin, pin_len);
+
+		case PINBLOCK_IBM4704:
+			return pinblock_decode_ibm4704(pinblock, pinblock_len, pin, pin_len);
+
+		case PINBLOCK_DOCUTEL:
+			return pinblock_decode_docutel(pinblock, pinblock_len, pin, pin_len);
+
+		case PINBLOCK_VISA2:
+			return pinblock_decode_visa2(pinblock, pinblock_len, pad_digit, pin, pin_len);
+
+		case PINBLOCK_VISA3:
+			return pinblock_decode_visa3(pinblock, pinblock_len, pad_digit, pin, pin_len);
+
+		case PINBLOCK_VISA4:
+			return pinblock_decode_visa4(pinblock, pinblock_len, pan, pan_len, pin, pin_len);
+
+		case PINBLOCK_ECI2:
+			return pinblock_decode_eci2(pinblock, pinblock_len, pin, pin_len);
+
+		case PINBLOCK_ECI3:
+			return pinblock_decode_eci3(pinblock, pinblock_len, pin, pin_len);
+
+		default:
+			// Unsupported source PIN block format
+			return -3;
+	}
+}
+
+int pinblock_translate_to_iso9564(
+	unsigned int src_format,
+	const uint8_t* src_pinblock,
+	size_t src_pinblock_len,
+	uint8_t pad_digit,
+	const uint8_t* pan,
+	size_t pan_len,
+	unsigned int format,
+	uint8_t* pinblock,
+	size_t pinblock_len
+)
+{
+	int r;
+	const struct pinblock_format_desc_t* desc;
+	uint8_t pin[12];
+	size_t pin_len;
+
+	if (!src_pinblock || !src_pinblock_len || !pinblock || !pinblock_len) {
+		return -1;
+	}
+
+	// Validate source and output PIN block formats
+	if (src_format >= PINBLOCK_PROPRIETARY_FORMAT_COUNT) {
+		return -3;
+	}
+	if (format > 0xF || pinblock_format_desc[format].block_size == 0) {
+		return -3;
+	}
+	desc = &pinblock_format_desc[format];
+	if (desc->pan_binding && (!pan || !pan_len)) {
+		return -1;
+	}
+	if (pinblock_len != desc->block_size) {
+		// Invalid PIN block size
+		return 1;
+	}
+
+	// Decode PIN using source PIN block format
+	r = pinblock_decode_proprietary(
+		src_format,
+		src_pinblock,
+		src_pinblock_len,
+		pad_digit,
+		pan,
+		pan_len,
+		pin,
+		&pin_len
+	);
+	if (r) {
+		goto exit;
+	}
+
+	// Encode PIN using output PIN block format
+	pinblock_encode_pinfield(
+		desc,
+		pin,
+		pin_len,
+		NULL,
+		0,
+		pan,
+		pan_len,
+		pinblock
+	);
+
+	// Success
+	r = 0;
+
+exit:
+	crypto_cleanse(pin, sizeof(pin));
+
+	return r;
+}
+
+int pinblock_translate_to_iso9564_batch(
+	unsigned int src_format,
+	const uint8_t* src_pinblocks,
+	size_t count,
+	uint8_t pad_digit,
+	const uint8_t* const* pans,
+	const size_t* pan_lens,
+	unsigned int format,
+	uint8_t* pinblocks
+)
+{
+	int r;
+	size_t block_size;
+	size_t invalid_count = 0;
+
+	if (!src_pinblocks || !count || !pinblocks) {
+		return -1;
+	}
+	if (!pans != !pan_lens) {
+		return -1;
+	}
+
+	// Validate source and output PIN block formats
+	if (src_format >= PINBLOCK_PROPRIETARY_FORMAT_COUNT) {
+		return -3;
+	}
+	if (format > 0xF || pinblock_format_desc[format].block_size == 0) {
+		return -3;
+	}
+	block_size = pinblock_format_desc[format].block_size;
+
+	for (size_t i = 0; i < count; ++i) {
+		uint8_t* pinblock = pinblocks + (i * block_size);
+
+		r = pinblock_translate_to_iso9564(
+			src_format,
+			src_pinblocks + (i * PINBLOCK_SIZE),
+			PINBLOCK_SIZE,
+			pad_digit,
+			pans ? pans[i] : NULL,
+			pans ? pan_lens[i] : 0,
+			format,
+			pinblock,
+			block_size
+		);
+		if (r) {
+			// Clear invalid PIN block such that it decodes as invalid
+			crypto_cleanse(pinblock, block_size);
+			++invalid_count;
 		}
 	}
 
-	// Unsupported PIN block size
-	return 1;
+	return invalid_count > INT_MAX ? INT_MAX : (int)invalid_count;
 }
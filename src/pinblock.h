@@ -30,6 +30,7 @@ __BEGIN_DECLS
 
 #define PINBLOCK_SIZE (8) ///< PIN block size (in bytes) for ISO 9564-1:2017 format 0, 1, 2, 3
 #define PINBLOCK128_SIZE (16) ///< PIN block size (in bytes) for ISO 9564-1:2017 format 4
+#define PINBLOCK_PIN_BCD_SIZE (7) ///< Packed BCD PIN size (in bytes)
 
 /**
  * PIN block formats
@@ -43,9 +44,26 @@ enum pinblock_format_t {
 	PINBLOCK_ISO9564_FORMAT_4 = 4, ///< ISO 9564-1:2017 format 4
 };
 
+/**
+ * PIN block validation results
+ * @see @ref pinblock_validate_batch
+ */
+enum pinblock_validation_result_t {
+	PINBLOCK_VALIDATION_OK = 0, ///< Valid PIN block
+	PINBLOCK_VALIDATION_UNSUPPORTED_FORMAT, ///< Invalid/unsupported PIN block format
+	PINBLOCK_VALIDATION_MISSING_PAN, ///< PAN required but not provided
+	PINBLOCK_VALIDATION_INVALID_PIN_LENGTH, ///< Invalid PIN length
+	PINBLOCK_VALIDATION_INVALID_PIN_DIGIT, ///< Invalid PIN digit
+	PINBLOCK_VALIDATION_INVALID_PADDING, ///< Invalid padding digit
+	PINBLOCK_VALIDATION_RESULT_COUNT, ///< Number of validation results
+};
+
 /**
  * Encode PIN block in accordance with ISO 9564-1:2017 PIN block format 0
  *
+ * @note The ANSI X9.8, VISA-1 and ECI-1 PIN block formats are the same as
+ *       ISO 9564-1:2017 PIN block format 0
+ *
  * @param pin PIN buffer containing one PIN digit value per byte
  * @param pin_len Length of PIN
  * @param pan PAN buffer in compressed numeric format (EMV format "cn";
@@ -91,6 +109,9 @@ int pinblock_decode_iso9564_format0(
 /**
  * Encode PIN block in accordance with ISO 9564-1:2017 PIN block format 1
  *
+ * @note The ECI-4 PIN block format is the same as ISO 9564-1:2017 PIN block
+ *       format 1
+ *
  * @param pin PIN buffer containing one PIN digit value per byte
  * @param pin_len Length of PIN
  * @param nonce Unique padding field. This field must be unique for every
@@ -262,6 +283,76 @@ int pinblock_decode_iso9564_format4_pinfield(
 	size_t* pin_len
 );
 
+/**
+ * Encode PIN block in accordance with ISO 9564-1:2017 PIN block format 0 as
+ * well as PIN field and PAN field in accordance with ISO 9564-1:2017 PIN
+ * block format 4, from the same PIN and PAN
+ *
+ * The PIN digits are packed once and the PAN is parsed once for both PIN
+ * block formats. The outputs are the same as those of
+ * @ref pinblock_encode_iso9564_format0,
+ * @ref pinblock_encode_iso9564_format4_pinfield and
+ * @ref pinblock_encode_iso9564_format4_panfield.
+ *
+ * @note It is the caller's responsibility to encipher and combine the format
+ *       4 PIN field and PAN field in accordance with ISO 9564-1:2017 9.4.2.3
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param pinblock Format 0 PIN block output of length @ref PINBLOCK_SIZE
+ * @param pinfield Format 4 PIN field output of length @ref PINBLOCK128_SIZE
+ * @param panfield Format 4 PAN field output of length @ref PINBLOCK128_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_iso9564_format0_format4(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock,
+	uint8_t* pinfield,
+	uint8_t* panfield
+);
+
+/**
+ * Encode multiple PINs in accordance with both ISO 9564-1:2017 PIN block
+ * format 0 and format 4
+ *
+ * @see @ref pinblock_encode_iso9564_format0_format4
+ *
+ * @param pins Array of @p count PIN buffers containing one PIN digit value
+ *             per byte
+ * @param pin_lens Array of @p count PIN lengths
+ * @param pans Array of @p count PAN buffers in compressed numeric format
+ *             (EMV format "cn")
+ * @param pan_lens Array of @p count PAN buffer lengths in bytes
+ * @param count Number of PINs
+ * @param pinblocks Consecutive format 0 PIN blocks output, each of length
+ *                  @ref PINBLOCK_SIZE
+ * @param pinfields Consecutive format 4 PIN fields output, each of length
+ *                  @ref PINBLOCK128_SIZE
+ * @param panfields Consecutive format 4 PAN fields output, each of length
+ *                  @ref PINBLOCK128_SIZE
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for the number of PINs with an invalid PIN length
+ *         or a missing PAN. The corresponding outputs are zero'd.
+ */
+int pinblock_encode_iso9564_format0_format4_batch(
+	const uint8_t* const* pins,
+	const size_t* pin_lens,
+	const uint8_t* const* pans,
+	const size_t* pan_lens,
+	size_t count,
+	uint8_t* pinblocks,
+	uint8_t* pinfields,
+	uint8_t* panfields
+);
+
 /**
  * Retrieve PIN block format
  *
@@ -299,6 +390,1028 @@ int pinblock_decode(
 	size_t* pin_len
 );
 
+/**
+ * Encode PIN block in accordance with ISO 9564-1:2017 using a packed BCD PIN
+ *
+ * The packed BCD PIN is @ref PINBLOCK_PIN_BCD_SIZE bytes long. The first
+ * byte is the PIN length and is followed by the PIN digits in compressed
+ * numeric format (nibble-per-digit; left justified; padded with trailing
+ * 0xF nibbles). This is the same as the ISO 9564-1:2017 PIN field without
+ * the control field and the last byte, and therefore allows the PIN field
+ * to be built without unpacking the PIN digits.
+ *
+ * @note For ISO 9564-1:2017 PIN block format 4, this encodes the PIN field
+ *       and it is the caller's responsibility to encipher and combine the
+ *       PIN field and PAN field in accordance with ISO 9564-1:2017 9.4.2.3
+ *
+ * @param format PIN block format. See @ref pinblock_format_t.
+ * @param pin_bcd Packed BCD PIN of length @ref PINBLOCK_PIN_BCD_SIZE
+ * @param other Secondary field that may be relevant for PIN block encoding.
+ *              For ISO 9564-1:2017 PIN block format 0 and format 3, this must
+ *              be the PAN in compressed numeric format (EMV format "cn").
+ *              For ISO 9564-1:2017 PIN block format 1, this is the optional
+ *              unique padding field. See @ref pinblock_encode_iso9564_format1.
+ *              For ISO 9564-1:2017 PIN block format 2 and format 4, this is
+ *              ignored.
+ * @param other_len Length of @p other in bytes
+ * @param pinblock PIN block output
+ * @param pinblock_len Length of PIN block output. Must be @ref PINBLOCK_SIZE
+ *                     or @ref PINBLOCK128_SIZE, depending on @p format.
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_encode_bcd(
+	unsigned int format,
+	const uint8_t* pin_bcd,
+	const uint8_t* other,
+	size_t other_len,
+	uint8_t* pinblock,
+	size_t pinblock_len
+);
+
+/**
+ * Decode PIN block in accordance with ISO 9564-1:2017 to a packed BCD PIN
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param other Secondary field that may be relevant for PIN block decoding.
+ *              For ISO 9564-1:2017 PIN block format 0 and format 3, this will
+ *              be the PAN in compressed numeric format (EMV format "cn").
+ *              For ISO 9564-1:2017 PIN block format 1, format 2 and format 4,
+ *              this is ignored.
+ * @param other_len Length of @p other in bytes
+ * @param format PIN block format output. See @ref pinblock_format_t.
+ * @param pin_bcd Packed BCD PIN output of length @ref PINBLOCK_PIN_BCD_SIZE.
+ *                See @ref pinblock_encode_bcd.
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_bcd(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* other,
+	size_t other_len,
+	unsigned int* format,
+	uint8_t* pin_bcd
+);
+
+/**
+ * Rebind ISO 9564-1:2017 PIN block format 0 or format 3 to a different PAN
+ *
+ * The old PAN field and the new PAN field are XOR'd directly into the PIN
+ * block without decoding the PIN. Only the control field and the PIN length
+ * are validated, and the padding digits remain unchanged.
+ *
+ * @param pinblock PIN block to be rebound in place
+ * @param pinblock_len Length of PIN block in bytes
+ * @param old_pan Old PAN buffer in compressed numeric format (EMV format
+ *                "cn"; nibble-per-digit; left justified; padded with
+ *                trailing 0xF nibbles)
+ * @param old_pan_len Length of old PAN buffer in bytes
+ * @param new_pan New PAN buffer in compressed numeric format (EMV format
+ *                "cn"; nibble-per-digit; left justified; padded with
+ *                trailing 0xF nibbles)
+ * @param new_pan_len Length of new PAN buffer in bytes
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_rebind_pan(
+	uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* old_pan,
+	size_t old_pan_len,
+	const uint8_t* new_pan,
+	size_t new_pan_len
+);
+
+/**
+ * Rebind multiple ISO 9564-1:2017 PIN block format 0 or format 3 PIN blocks
+ * from the same old PAN to the same new PAN
+ *
+ * @see @ref pinblock_rebind_pan
+ *
+ * @param pinblocks Consecutive PIN blocks, each of length @ref PINBLOCK_SIZE,
+ *                  to be rebound in place
+ * @param count Number of PIN blocks
+ * @param old_pan Old PAN buffer in compressed numeric format (EMV format
+ *                "cn"; nibble-per-digit; left justified; padded with
+ *                trailing 0xF nibbles)
+ * @param old_pan_len Length of old PAN buffer in bytes
+ * @param new_pan New PAN buffer in compressed numeric format (EMV format
+ *                "cn"; nibble-per-digit; left justified; padded with
+ *                trailing 0xF nibbles)
+ * @param new_pan_len Length of new PAN buffer in bytes
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for the number of PIN blocks with an
+ *         invalid/unsupported PIN block format, which remain unchanged.
+ */
+int pinblock_rebind_pan_batch(
+	uint8_t* pinblocks,
+	size_t count,
+	const uint8_t* old_pan,
+	size_t old_pan_len,
+	const uint8_t* new_pan,
+	size_t new_pan_len
+);
+
+/**
+ * Convert PIN block between ISO 9564-1:2017 PIN block format 0, format 1,
+ * format 2 and format 3
+ *
+ * The PIN field is validated and converted as a whole without extracting the
+ * PIN digits. The control field is replaced, the padding digits are replaced
+ * with those of the destination format, and the PAN field is removed and/or
+ * applied as required by the source and destination formats.
+ *
+ * @param pinblock PIN block to be converted
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). Required if either the source or destination format
+ *            is ISO 9564-1:2017 PIN block format 0 or format 3. Otherwise
+ *            ignored.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param format Destination PIN block format. See @ref pinblock_format_t.
+ * @param converted_pinblock Converted PIN block output of length
+ *                           @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_convert(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	unsigned int format,
+	uint8_t* converted_pinblock
+);
+
+/**
+ * Convert multiple PIN blocks between ISO 9564-1:2017 PIN block format 0,
+ * format 1, format 2 and format 3
+ *
+ * @see @ref pinblock_convert
+ *
+ * @param pinblocks Consecutive PIN blocks, each of length @ref PINBLOCK_SIZE
+ * @param count Number of PIN blocks
+ * @param pans Array of @p count PAN buffers in compressed numeric format (EMV
+ *             format "cn"), one per PIN block. May be NULL if neither the
+ *             PIN blocks nor the destination format require a PAN.
+ * @param pan_lens Array of @p count PAN buffer lengths in bytes. Must be NULL
+ *                 if @p pans is NULL.
+ * @param format Destination PIN block format. See @ref pinblock_format_t.
+ * @param converted_pinblocks Consecutive converted PIN blocks output, each of
+ *                            length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for the number of PIN blocks that could not be
+ *         converted. The corresponding output PIN blocks are zero'd.
+ */
+int pinblock_convert_batch(
+	const uint8_t* pinblocks,
+	size_t count,
+	const uint8_t* const* pans,
+	const size_t* pan_lens,
+	unsigned int format,
+	uint8_t* converted_pinblocks
+);
+
+/**
+ * Validate multiple ISO 9564-1:2017 PIN block format 0, format 1, format 2
+ * or format 3 PIN blocks without decoding the PINs
+ *
+ * The same control field, PIN length, PIN digit and padding digit checks as
+ * the decoding functions are applied, but no PIN digits are written.
+ *
+ * @param pinblocks Consecutive PIN blocks, each of length @ref PINBLOCK_SIZE
+ * @param count Number of PIN blocks
+ * @param pans Array of @p count PAN buffers in compressed numeric format (EMV
+ *             format "cn"), one per PIN block. May be NULL if none of the
+ *             PIN blocks require a PAN.
+ * @param pan_lens Array of @p count PAN buffer lengths in bytes. Must be NULL
+ *                 if @p pans is NULL.
+ * @param validity Optional validity bitmap output of at least
+ *                 <tt>(count + 7) / 8</tt> bytes. The bit for PIN block
+ *                 @c i is bit <tt>(i % 8)</tt>, counting from the least
+ *                 significant bit, of byte <tt>(i / 8)</tt> and is set if
+ *                 the PIN block is valid.
+ * @param histogram Optional output of @ref PINBLOCK_VALIDATION_RESULT_COUNT
+ *                  counters, indexed by @ref pinblock_validation_result_t,
+ *                  that are incremented for each PIN block
+ * @return Zero if all PIN blocks are valid. Less than zero for error.
+ *         Greater than zero for the number of invalid PIN blocks.
+ */
+int pinblock_validate_batch(
+	const uint8_t* pinblocks,
+	size_t count,
+	const uint8_t* const* pans,
+	const size_t* pan_lens,
+	uint8_t* validity,
+	size_t* histogram
+);
+
+/**
+ * Shadow verification callback
+ *
+ * @param kernel Name of the function for which the result did not match the
+ *               reference implementation
+ * @param ctx Context pointer provided to @ref pinblock_shadow_configure
+ */
+typedef void (*pinblock_shadow_callback_t)(const char* kernel, void* ctx);
+
+/**
+ * Shadow verification statistics
+ * @see @ref pinblock_shadow_get_stats
+ */
+struct pinblock_shadow_stats_t {
+	unsigned long verified; ///< Number of results verified
+	unsigned long mismatched; ///< Number of results that did not match
+	unsigned long rate_limited; ///< Number of samples skipped due to rate limit
+};
+
+/**
+ * Configure shadow verification of the 64-bit PIN field and batch
+ * implementations
+ *
+ * When enabled, a sample of the results of @ref pinblock_encode_bcd,
+ * @ref pinblock_decode_bcd, @ref pinblock_rebind_pan,
+ * @ref pinblock_rebind_pan_batch, @ref pinblock_convert,
+ * @ref pinblock_convert_batch, @ref pinblock_validate_batch and
+ * @ref pinblock_encode_iso9564_format0_format4 are recomputed using the
+ * reference digit-by-digit implementation and compared in constant time.
+ * Mismatches are counted and reported to the optional callback. Shadow
+ * verification is disabled by default.
+ *
+ * The shadow verification configuration, rate limit and statistics are
+ * process-wide and are shared by all threads and all callers in the process.
+ * They are the only state kept by this library between calls; all other
+ * functions only depend on their parameters.
+ *
+ * Each thread counts down to its next sample without atomic operations, and
+ * only reads the process-wide configuration when its countdown expires.
+ * Threads other than the calling thread therefore keep sampling according to
+ * their previous configuration until their current countdown expires. That
+ * is after at most the previous @p sample_interval calls, or after at most
+ * 65536 calls if shadow verification was previously disabled.
+ *
+ * @note This function resets the shadow verification statistics and must not
+ *       be called concurrently with other functions of this library.
+ *
+ * @param sample_interval Verify one out of every @p sample_interval results
+ *                        per thread. Zero to disable shadow verification.
+ * @param max_per_second Approximate maximum number of verifications per
+ *                       second across all threads. Zero for no limit.
+ * @param callback Optional callback for mismatches. NULL to only count them.
+ * @param ctx Context pointer to pass to @p callback
+ * @return Zero for success. Greater than zero if shadow verification is not
+ *         supported because the compiler does not support atomics.
+ */
+int pinblock_shadow_configure(
+	unsigned int sample_interval,
+	unsigned int max_per_second,
+	pinblock_shadow_callback_t callback,
+	void* ctx
+);
+
+/**
+ * Retrieve shadow verification statistics
+ *
+ * @param stats Shadow verification statistics output
+ */
+void pinblock_shadow_get_stats(struct pinblock_shadow_stats_t* stats);
+
+/**
+ * RNG health test failures
+ * @see @ref pinblock_rng_health_t
+ */
+enum pinblock_rng_health_failure_t {
+	PINBLOCK_RNG_HEALTH_RCT_FAILED = 0x01, ///< Repetition count test failed
+	PINBLOCK_RNG_HEALTH_APT_FAILED = 0x02, ///< Adaptive proportion test failed
+};
+
+/**
+ * RNG health monitor state for a single PIN block originator, typically a
+ * terminal or PIN pad. This state is of constant size and owned by the
+ * caller.
+ * @see @ref pinblock_rng_health_init
+ * @see @ref pinblock_rng_health_update
+ */
+struct pinblock_rng_health_t {
+	uint8_t rct_sample; ///< Repetition count test: last sample
+	uint8_t rct_count; ///< Repetition count test: number of repetitions
+	uint8_t apt_sample; ///< Adaptive proportion test: reference sample
+	uint16_t apt_count; ///< Adaptive proportion test: reference sample count
+	uint16_t apt_window_count; ///< Adaptive proportion test: samples in window
+	uint8_t failures; ///< Failed tests. See @ref pinblock_rng_health_failure_t.
+};
+
+/**
+ * Initialise RNG health monitor state
+ *
+ * @param health RNG health monitor state
+ */
+void pinblock_rng_health_init(struct pinblock_rng_health_t* health);
+
+/**
+ * Update RNG health monitor with the random padding of an ISO 9564-1:2017
+ * PIN block format 3 PIN block or format 4 PIN field
+ *
+ * The random padding digits of format 3 and the random last 8 bytes of the
+ * format 4 PIN field are fed, one digit at a time, to the NIST SP 800-90B
+ * repetition count test and adaptive proportion test. Test failures are
+ * accumulated in @ref pinblock_rng_health_t::failures until the state is
+ * initialised again. Invalid PIN blocks do not contribute to the tests.
+ *
+ * @note This function only updates the RNG health monitor. To decode the
+ *       PIN and update the RNG health monitor from the same PIN field, use
+ *       @ref pinblock_rng_health_decode instead of a separate decode call.
+ *
+ * @note Format 1 is not supported because its padding digits may be a
+ *       transaction sequence number instead of random data.
+ *
+ * @param health RNG health monitor state
+ * @param pinblock Format 3 PIN block of length @ref PINBLOCK_SIZE or
+ *                 deciphered format 4 PIN field of length
+ *                 @ref PINBLOCK128_SIZE
+ * @param pinblock_len Length of @p pinblock in bytes
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). Required for format 3. Ignored for format 4.
+ * @param pan_len Length of PAN buffer in bytes
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_rng_health_update(
+	struct pinblock_rng_health_t* health,
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len
+);
+
+/**
+ * Decode ISO 9564-1:2017 PIN block format 3 PIN block or format 4 PIN field
+ * and update RNG health monitor with its random padding
+ *
+ * This is the format 3 and format 4 decoder with the RNG health monitor
+ * built in. The PAN field is built once and the random padding digits are
+ * taken from the same PIN field from which the PIN is decoded, such that
+ * monitoring adds only the cost of the health tests to decoding. The health
+ * tests are the same as for @ref pinblock_rng_health_update.
+ *
+ * @param health RNG health monitor state of the PIN block originator. NULL
+ *               to decode without updating an RNG health monitor.
+ * @param pinblock Format 3 PIN block of length @ref PINBLOCK_SIZE or
+ *                 deciphered format 4 PIN field of length
+ *                 @ref PINBLOCK128_SIZE
+ * @param pinblock_len Length of @p pinblock in bytes
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). Required for format 3. Ignored for format 4.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param pin PIN buffer output of maximum 12 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_rng_health_decode(
+	struct pinblock_rng_health_t* health,
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Additional checks for strict PIN block decoding
+ * @see @ref pinblock_decode_strict
+ * @see @ref pinblock_get_false_acceptance
+ */
+struct pinblock_decode_strictness_t {
+	/// Expected PIN length, for example if all PINs of a card scheme have the
+	/// same length. Zero to accept any valid PIN length.
+	size_t pin_len;
+
+	/// Expected ISO 9564-1:2017 PIN block format 1 nonce, encoded in the same
+	/// way as for @ref pinblock_encode_iso9564_format1. NULL to accept any
+	/// nonce.
+	const uint8_t* nonce;
+
+	/// Length of @ref nonce in bytes
+	size_t nonce_len;
+};
+
+/**
+ * Determine the probability that a PIN block deciphered using an incorrect
+ * key is nevertheless accepted by @ref pinblock_decode or
+ * @ref pinblock_decode_strict for the specified PIN block format
+ *
+ * An incorrectly deciphered PIN block is assumed to be uniformly random. The
+ * probability is expressed as the number of accepted 64-bit PIN fields out
+ * of 2^64. For example, ISO 9564-1:2017 PIN block format 1 accepts roughly
+ * 2^-9.3 of random PIN fields, format 3 accepts roughly 2^-17.7 and format 0,
+ * format 2 and format 4 accept roughly 2^-24.0. Providing the expected nonce
+ * or the expected PIN length reduces the probability accordingly.
+ *
+ * @note This does not apply to a correctly deciphered format 0 or format 3
+ *       PIN block that is decoded using an incorrect PAN because such a
+ *       PIN field is not random.
+ *
+ * @param format PIN block format. See @ref pinblock_format_t.
+ * @param strictness Optional additional checks. NULL for none.
+ * @param false_acceptance Number of accepted PIN fields out of 2^64 output
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_get_false_acceptance(
+	unsigned int format,
+	const struct pinblock_decode_strictness_t* strictness,
+	uint64_t* false_acceptance
+);
+
+/**
+ * Decode PIN block in accordance with ISO 9564-1:2017 and apply additional
+ * checks that reduce the probability of accepting a PIN block that was
+ * deciphered using an incorrect key
+ *
+ * @see @ref pinblock_decode
+ * @see @ref pinblock_get_false_acceptance
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param other Secondary field that may be relevant for PIN block decoding.
+ *              See @ref pinblock_decode.
+ * @param other_len Length of @p other in bytes
+ * @param strictness Optional additional checks. NULL for none.
+ * @param format PIN block format output. See @ref pinblock_format_t.
+ * @param pin PIN buffer output of maximum 12 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_strict(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* other,
+	size_t other_len,
+	const struct pinblock_decode_strictness_t* strictness,
+	unsigned int* format,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with IBM 3624 PIN block format. The PIN
+ * digits are left justified and padded with the pad digit:
+ * <tt>P P P P P/X ... X</tt>
+ *
+ * @note The Diebold/IBM ATM PIN block format is the IBM 3624 PIN block
+ *       format with a pad digit of 0xF.
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN
+ * @param pad_digit Pad digit value from 0x0 to 0xF
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_ibm3624(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t pad_digit,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with IBM 3624 PIN block format
+ *
+ * @note The Diebold/IBM ATM PIN block format is the IBM 3624 PIN block
+ *       format with a pad digit of 0xF.
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pad_digit Pad digit value from 0xA to 0xF. Decimal pad digits are
+ *                  not supported because the PIN length would be ambiguous.
+ * @param pin PIN buffer output of maximum 12 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_ibm3624(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t pad_digit,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with IBM 4704 Encrypting PIN Pad (EPP) PIN
+ * block format. The control field 0x1 and the PIN length are followed by the
+ * PIN digits and padded with 0xF: <tt>1 L P P P P P/F ... F</tt>
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_ibm4704(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with IBM 4704 Encrypting PIN Pad (EPP) PIN
+ * block format
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pin PIN buffer output of maximum 12 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_ibm4704(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with Docutel ATM PIN block format. The PIN
+ * length is followed by the PIN digits and padded with user defined padding
+ * digits: <tt>L P P P P P/X P/X X ... X</tt>
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN. Must be 4 to 6 digits.
+ * @param pad Padding digits in nibble-per-digit format, of which the leading
+ *            digits are used in order. Use NULL for random padding.
+ * @param pad_len Length of padding buffer in bytes. Must be at least
+ *                <tt>(PINBLOCK_SIZE * 2 - pin_len) / 2</tt>. Use zero for
+ *                random padding.
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_docutel(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pad,
+	size_t pad_len,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with Docutel ATM PIN block format
+ *
+ * @note Padding digits are user defined and are not validated
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pin PIN buffer output of maximum 6 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_docutel(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with VISA-2 PIN block format. The PIN
+ * length is followed by the PIN digits and padded with a decimal pad digit:
+ * <tt>L P P P P P/D ... D</tt>
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN
+ * @param pad_digit Pad digit value from 0x0 to 0x9. Typically 0x0.
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_visa2(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t pad_digit,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with VISA-2 PIN block format
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pad_digit Pad digit value from 0x0 to 0x9
+ * @param pin PIN buffer output of maximum 12 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_visa2(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t pad_digit,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with VISA-3 PIN block format. The PIN
+ * digits are left justified, delimited by 0xF and padded with the pad digit:
+ * <tt>P P P P P/F P/X ... X</tt>
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN
+ * @param pad_digit Pad digit value from 0x0 to 0xF
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_visa3(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t pad_digit,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with VISA-3 PIN block format
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pad_digit Pad digit value from 0x0 to 0xF
+ * @param pin PIN buffer output of maximum 12 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_visa3(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t pad_digit,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with VISA-4 PIN block format. The PIN
+ * digits are left justified and padded with 0xF, and then XOR'd with the
+ * same PAN field as ISO 9564-1:2017 PIN block format 0.
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_visa4(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with VISA-4 PIN block format
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param pin PIN buffer output of maximum 12 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_visa4(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with ECI-2 PIN block format. The 4 digit
+ * PIN is followed by random padding digits: <tt>P P P P R ... R</tt>
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN. Must be 4 digits.
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_eci2(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with ECI-2 PIN block format
+ *
+ * @note Padding digits are random and are not validated
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pin PIN buffer output of maximum 4 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_eci2(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with ECI-3 PIN block format. The PIN
+ * length is followed by the PIN digits and padded with random digits:
+ * <tt>L P P P P P/R P/R R ... R</tt>
+ *
+ * @note This is the same layout as the Docutel ATM PIN block format with
+ *       random padding
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN. Must be 4 to 6 digits.
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_eci3(
+	const uint8_t* pin,
+	size_t pin_len,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with ECI-3 PIN block format
+ *
+ * @note Padding digits are random and are not validated
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pin PIN buffer output of maximum 6 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_eci3(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with Mastercard Pay Now & Pay Later (PNPL)
+ * PIN block format. The PIN field is the same as ISO 9564-1:2017 PIN block
+ * format 2 and is XOR'd with the same PAN field as ISO 9564-1:2017 PIN block
+ * format 0.
+ *
+ * @param pin PIN buffer containing one PIN digit value per byte
+ * @param pin_len Length of PIN
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_mastercard_pnpl(
+	const uint8_t* pin,
+	size_t pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with Mastercard Pay Now & Pay Later (PNPL)
+ * PIN block format
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param pin PIN buffer output of maximum 12 bytes/digits
+ * @param pin_len Length of PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_mastercard_pnpl(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pin,
+	size_t* pin_len
+);
+
+/**
+ * Encode PIN block in accordance with Visa PIN change PIN block format. The
+ * new PIN is encoded in the same manner as ISO 9564-1:2017 PIN block format 0
+ * and is then XOR'd with the old PIN, left justified and padded with zeros.
+ *
+ * @param new_pin New PIN buffer containing one PIN digit value per byte
+ * @param new_pin_len Length of new PIN
+ * @param old_pin Old PIN buffer containing one PIN digit value per byte. Use
+ *                NULL for the Visa new PIN only format, which is the same as
+ *                ISO 9564-1:2017 PIN block format 0.
+ * @param old_pin_len Length of old PIN
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param pinblock PIN block output of length @ref PINBLOCK_SIZE
+ * @return Zero for success. Less than zero for error.
+ */
+int pinblock_encode_visa_pin_change(
+	const uint8_t* new_pin,
+	size_t new_pin_len,
+	const uint8_t* old_pin,
+	size_t old_pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* pinblock
+);
+
+/**
+ * Decode PIN block in accordance with Visa PIN change PIN block format
+ *
+ * @param pinblock PIN block
+ * @param pinblock_len Length of PIN block in bytes
+ * @param old_pin Old PIN buffer containing one PIN digit value per byte. Use
+ *                NULL for the Visa new PIN only format.
+ * @param old_pin_len Length of old PIN
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param new_pin New PIN buffer output of maximum 12 bytes/digits
+ * @param new_pin_len Length of new PIN buffer output
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_decode_visa_pin_change(
+	const uint8_t* pinblock,
+	size_t pinblock_len,
+	const uint8_t* old_pin,
+	size_t old_pin_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	uint8_t* new_pin,
+	size_t* new_pin_len
+);
+
+/**
+ * Translate Visa PIN change request to ISO 9564-1:2017 PIN block containing
+ * the new PIN. The old PIN is decoded and validated from the ISO 9564-1:2017
+ * format 0 PIN block, used to decode and validate the new PIN from the Visa
+ * PIN change PIN block, and the new PIN is then encoded using the output
+ * PIN block format. Neither PIN is exposed to the caller.
+ *
+ * @note For ISO 9564-1:2017 PIN block format 4, the output is the PIN field
+ *       and it is the caller's responsibility to encipher and combine the
+ *       PIN field and PAN field in accordance with ISO 9564-1:2017 9.4.2.3
+ *
+ * @param old_pinblock Old PIN block in ISO 9564-1:2017 PIN block format 0
+ * @param old_pinblock_len Length of old PIN block in bytes
+ * @param pin_change_pinblock PIN block in Visa PIN change PIN block format
+ * @param pin_change_pinblock_len Length of Visa PIN change PIN block in bytes
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param format Output PIN block format. See @ref pinblock_format_t.
+ * @param pinblock PIN block output
+ * @param pinblock_len Length of PIN block output. Must be @ref PINBLOCK_SIZE
+ *                     or @ref PINBLOCK128_SIZE, depending on @p format.
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_translate_visa_pin_change(
+	const uint8_t* old_pinblock,
+	size_t old_pinblock_len,
+	const uint8_t* pin_change_pinblock,
+	size_t pin_change_pinblock_len,
+	const uint8_t* pan,
+	size_t pan_len,
+	unsigned int format,
+	uint8_t* pinblock,
+	size_t pinblock_len
+);
+
+/**
+ * Proprietary PIN block formats
+ * @see @ref pinblock_translate_to_iso9564
+ */
+enum pinblock_proprietary_format_t {
+	PINBLOCK_IBM3624 = 0, ///< IBM 3624 PIN block format
+	PINBLOCK_IBM4704, ///< IBM 4704 Encrypting PIN Pad (EPP) PIN block format
+	PINBLOCK_DOCUTEL, ///< Docutel ATM PIN block format
+	PINBLOCK_VISA2, ///< VISA-2 PIN block format
+	PINBLOCK_VISA3, ///< VISA-3 PIN block format
+	PINBLOCK_VISA4, ///< VISA-4 PIN block format
+	PINBLOCK_ECI2, ///< ECI-2 PIN block format
+	PINBLOCK_ECI3, ///< ECI-3 PIN block format
+	PINBLOCK_PROPRIETARY_FORMAT_COUNT, ///< Number of proprietary PIN block formats
+};
+
+/**
+ * Translate PIN block from a proprietary PIN block format to an
+ * ISO 9564-1:2017 PIN block format. The PIN is decoded and validated using
+ * the decoder of the source PIN block format and then encoded using the
+ * output PIN block format. The PIN is not exposed to the caller.
+ *
+ * @note For ISO 9564-1:2017 PIN block format 4, the output is the PIN field
+ *       and it is the caller's responsibility to encipher and combine the
+ *       PIN field and PAN field in accordance with ISO 9564-1:2017 9.4.2.3
+ *
+ * @param src_format Source PIN block format.
+ *                   See @ref pinblock_proprietary_format_t.
+ * @param src_pinblock Source PIN block
+ * @param src_pinblock_len Length of source PIN block in bytes
+ * @param pad_digit Pad digit of IBM 3624, VISA-2 or VISA-3 source PIN block
+ *                  format. Ignored for other source PIN block formats.
+ * @param pan PAN buffer in compressed numeric format (EMV format "cn";
+ *            nibble-per-digit; left justified; padded with trailing 0xF
+ *            nibbles). This is the same format as EMV field @c 5A which
+ *            typically contains the application PAN. Required if either
+ *            PIN block format uses the PAN, otherwise NULL.
+ * @param pan_len Length of PAN buffer in bytes
+ * @param format Output PIN block format. See @ref pinblock_format_t.
+ * @param pinblock PIN block output
+ * @param pinblock_len Length of PIN block output. Must be @ref PINBLOCK_SIZE
+ *                     or @ref PINBLOCK128_SIZE, depending on @p format.
+ * @return Zero for success. Less than zero for error.
+ *         Greater than zero for invalid/unsupported PIN block format.
+ */
+int pinblock_translate_to_iso9564(
+	unsigned int src_format,
+	const uint8_t* src_pinblock,
+	size_t src_pinblock_len,
+	uint8_t pad_digit,
+	const uint8_t* pan,
+	size_t pan_len,
+	unsigned int format,
+	uint8_t* pinblock,
+	size_t pinblock_len
+);
+
+/**
+ * Translate consecutive PIN blocks from a proprietary PIN block format to an
+ * ISO 9564-1:2017 PIN block format.
+ * @see @ref pinblock_translate_to_iso9564
+ *
+ * @note PIN blocks that cannot be translated are cleared in the output
+ *
+ * @param src_format Source PIN block format.
+ *                   See @ref pinblock_proprietary_format_t.
+ * @param src_pinblocks Consecutive source PIN blocks of @ref PINBLOCK_SIZE
+ *                      bytes each
+ * @param count Number of PIN blocks
+ * @param pad_digit Pad digit of IBM 3624, VISA-2 or VISA-3 source PIN block
+ *                  format. Ignored for other source PIN block formats.
+ * @param pans Array of @p count PAN buffers in compressed numeric format
+ *             (EMV format "cn"). Required if either PIN block format uses
+ *             the PAN, otherwise NULL.
+ * @param pan_lens Array of @p count PAN buffer lengths in bytes
+ * @param format Output PIN block format. See @ref pinblock_format_t.
+ * @param pinblocks Consecutive PIN blocks output of @p count times
+ *                  @ref PINBLOCK_SIZE or @ref PINBLOCK128_SIZE bytes,
+ *                  depending on @p format
+ * @return Number of PIN blocks that could not be translated.
+ *         Less than zero for error.
+ */
+int pinblock_translate_to_iso9564_batch(
+	unsigned int src_format,
+	const uint8_t* src_pinblocks,
+	size_t count,
+	uint8_t pad_digit,
+	const uint8_t* const* pans,
+	const size_t* pan_lens,
+	unsigned int format,
+	uint8_t* pinblocks
+);
+
 __END_DECLS
 
 #endif
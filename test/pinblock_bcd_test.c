@@ -0,0 +1,284 @@
+/**
+ * @file pinblock_bcd_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Example from Thales payShield Host Programmer's Manual v1.2a (page 234)
+static const uint8_t pin_bcd[] = { 0x05, 0x34, 0x56, 0x7F, 0xFF, 0xFF, 0xFF };
+static const uint8_t pinblock_verify[] = { 0x25, 0x34, 0x56, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF };
+
+// Hand made example
+static const uint8_t pin2[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x00, 0x01, 0x02 };
+static const uint8_t pin2_bcd[] = { 0x0C, 0x12, 0x34, 0x56, 0x78, 0x90, 0x12 };
+static const uint8_t pan2[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t nonce2[] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 };
+
+// Invalid packed BCD PIN
+static const uint8_t bad_pin_bcd[] = { 0x04, 0x12, 0x3A, 0xFF, 0xFF, 0xFF, 0xFF };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t pinblock2[PINBLOCK_SIZE];
+	uint8_t pinfield[PINBLOCK128_SIZE];
+	unsigned int format;
+	uint8_t decoded_pin_bcd[PINBLOCK_PIN_BCD_SIZE];
+
+	// Test ISO 9564-1:2017 PIN block format 2 encoding
+	r = pinblock_encode_bcd(
+		PINBLOCK_ISO9564_FORMAT_2,
+		pin_bcd,
+		NULL,
+		0,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 2 decoding
+	r = pinblock_decode_bcd(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		&format,
+		decoded_pin_bcd
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (format != PINBLOCK_ISO9564_FORMAT_2) {
+		fprintf(stderr, "Decoded PIN block format is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin_bcd, pin_bcd, sizeof(pin_bcd)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin_bcd", decoded_pin_bcd, sizeof(decoded_pin_bcd));
+		print_buf("pin_bcd", pin_bcd, sizeof(pin_bcd));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 0 encoding consistency
+	r = pinblock_encode_bcd(
+		PINBLOCK_ISO9564_FORMAT_0,
+		pin2_bcd,
+		pan2,
+		sizeof(pan2),
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format0(
+		pin2,
+		sizeof(pin2),
+		pan2,
+		sizeof(pan2),
+		pinblock2
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock2, sizeof(pinblock2)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock2", pinblock2, sizeof(pinblock2));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 1 encoding consistency
+	r = pinblock_encode_bcd(
+		PINBLOCK_ISO9564_FORMAT_1,
+		pin2_bcd,
+		nonce2,
+		sizeof(nonce2),
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format1(
+		pin2,
+		sizeof(pin2),
+		nonce2,
+		sizeof(nonce2),
+		pinblock2
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format1() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock2, sizeof(pinblock2)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock2", pinblock2, sizeof(pinblock2));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 3 encoding and decoding
+	r = pinblock_encode_bcd(
+		PINBLOCK_ISO9564_FORMAT_3,
+		pin_bcd,
+		pan2,
+		sizeof(pan2),
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_decode_bcd(
+		pinblock,
+		sizeof(pinblock),
+		pan2,
+		sizeof(pan2),
+		&format,
+		decoded_pin_bcd
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (format != PINBLOCK_ISO9564_FORMAT_3) {
+		fprintf(stderr, "Decoded PIN block format is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin_bcd, pin_bcd, sizeof(pin_bcd)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin_bcd", decoded_pin_bcd, sizeof(decoded_pin_bcd));
+		print_buf("pin_bcd", pin_bcd, sizeof(pin_bcd));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 4 encoding and decoding
+	r = pinblock_encode_bcd(
+		PINBLOCK_ISO9564_FORMAT_4,
+		pin2_bcd,
+		NULL,
+		0,
+		pinfield,
+		sizeof(pinfield)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_decode_bcd(
+		pinfield,
+		sizeof(pinfield),
+		NULL,
+		0,
+		&format,
+		decoded_pin_bcd
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (format != PINBLOCK_ISO9564_FORMAT_4) {
+		fprintf(stderr, "Decoded PIN block format is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin_bcd, pin2_bcd, sizeof(pin2_bcd)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin_bcd", decoded_pin_bcd, sizeof(decoded_pin_bcd));
+		print_buf("pin2_bcd", pin2_bcd, sizeof(pin2_bcd));
+		r = 1;
+		goto exit;
+	}
+
+	// Test PIN digit validation
+	r = pinblock_encode_bcd(
+		PINBLOCK_ISO9564_FORMAT_2,
+		bad_pin_bcd,
+		NULL,
+		0,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_encode_bcd() unexpectedly succeeded with bad PIN\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test padding validation
+	memcpy(pinblock, pinblock_verify, sizeof(pinblock_verify));
+	pinblock[7] ^= 1;
+	r = pinblock_decode_bcd(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		&format,
+		decoded_pin_bcd
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_bcd() unexpectedly succeeded with bad PIN block\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
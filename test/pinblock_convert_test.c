@@ -0,0 +1,277 @@
+/**
+ * @file pinblock_convert_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t pan[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t converted_pinblock[PINBLOCK_SIZE];
+	uint8_t pinblock_verify[PINBLOCK_SIZE];
+	uint8_t pinblocks[3 * PINBLOCK_SIZE];
+	uint8_t converted_pinblocks[3 * PINBLOCK_SIZE];
+	uint8_t pinblocks_verify[3 * PINBLOCK_SIZE];
+	const uint8_t* pans[3] = { pan, pan, pan };
+	size_t pan_lens[3] = { sizeof(pan), sizeof(pan), sizeof(pan) };
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test ISO 9564-1:2017 PIN block format 3 to format 0 conversion
+	r = pinblock_encode_iso9564_format3(pin, sizeof(pin), pan, sizeof(pan), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format3() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), pan, sizeof(pan), pinblock_verify);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_convert(
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_0,
+		converted_pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_convert() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(converted_pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("converted_pinblock", converted_pinblock, sizeof(converted_pinblock));
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 0 to format 2 conversion
+	r = pinblock_encode_iso9564_format2(pin, sizeof(pin), pinblock_verify);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format2() failed; r=%d\n", r);
+		goto exit;
+	}
+	memcpy(pinblock, converted_pinblock, sizeof(pinblock));
+	r = pinblock_convert(
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_2,
+		converted_pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_convert() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(converted_pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("converted_pinblock", converted_pinblock, sizeof(converted_pinblock));
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 2 to format 1 conversion without PAN
+	memcpy(pinblock, converted_pinblock, sizeof(pinblock));
+	r = pinblock_convert(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		PINBLOCK_ISO9564_FORMAT_1,
+		converted_pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_convert() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_decode_iso9564_format1(
+		converted_pinblock,
+		sizeof(converted_pinblock),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_iso9564_format1() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin) ||
+		memcmp(decoded_pin, pin, sizeof(pin)) != 0
+	) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, decoded_pin_len);
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 1 to format 3 conversion
+	memcpy(pinblock, converted_pinblock, sizeof(pinblock));
+	r = pinblock_convert(
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_3,
+		converted_pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_convert() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_decode_iso9564_format3(
+		converted_pinblock,
+		sizeof(converted_pinblock),
+		pan,
+		sizeof(pan),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_iso9564_format3() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin) ||
+		memcmp(decoded_pin, pin, sizeof(pin)) != 0
+	) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, decoded_pin_len);
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test conversion to format 0 without PAN
+	r = pinblock_convert(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		PINBLOCK_ISO9564_FORMAT_0,
+		converted_pinblock
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_convert() unexpectedly succeeded without PAN\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test unsupported destination PIN block format
+	r = pinblock_convert(
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_4,
+		converted_pinblock
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_convert() unexpectedly succeeded with format 4\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test invalid PIN digit
+	pinblock[2] ^= 0xC0;
+	r = pinblock_convert(
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_0,
+		converted_pinblock
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_convert() unexpectedly succeeded with invalid PIN digit\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test batch conversion with one unsupported PIN block format
+	r = pinblock_encode_iso9564_format3(pin, sizeof(pin), pan, sizeof(pan), pinblocks);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format3() failed; r=%d\n", r);
+		goto exit;
+	}
+	memset(pinblocks + PINBLOCK_SIZE, 0xCC, PINBLOCK_SIZE);
+	r = pinblock_encode_iso9564_format2(pin, sizeof(pin), pinblocks + 2 * PINBLOCK_SIZE);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format2() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), pan, sizeof(pan), pinblock_verify);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	memcpy(pinblocks_verify, pinblock_verify, PINBLOCK_SIZE);
+	memset(pinblocks_verify + PINBLOCK_SIZE, 0, PINBLOCK_SIZE);
+	memcpy(pinblocks_verify + 2 * PINBLOCK_SIZE, pinblock_verify, PINBLOCK_SIZE);
+	r = pinblock_convert_batch(
+		pinblocks,
+		3,
+		pans,
+		pan_lens,
+		PINBLOCK_ISO9564_FORMAT_0,
+		converted_pinblocks
+	);
+	if (r != 1) {
+		fprintf(stderr, "pinblock_convert_batch() failed; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(converted_pinblocks, pinblocks_verify, sizeof(pinblocks_verify)) != 0) {
+		fprintf(stderr, "PIN blocks are incorrect\n");
+		print_buf("converted_pinblocks", converted_pinblocks, sizeof(converted_pinblocks));
+		print_buf("pinblocks_verify", pinblocks_verify, sizeof(pinblocks_verify));
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
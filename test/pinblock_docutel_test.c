@@ -0,0 +1,183 @@
+/**
+ * @file pinblock_docutel_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04 };
+static const uint8_t pad[] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB };
+static const uint8_t pinblock_verify[] = { 0x41, 0x23, 0x40, 0x12, 0x34, 0x56, 0x78, 0x9A };
+
+// Hand made example
+static const uint8_t pin2[] = { 0x09, 0x08, 0x07, 0x06, 0x05, 0x04 };
+static const uint8_t pinblock_verify2[] = { 0x69, 0x87, 0x65, 0x4 }; // This is as much as we can directly compare
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test Docutel PIN block format encoding using padding digits
+	r = pinblock_encode_docutel(
+		pin,
+		sizeof(pin),
+		pad,
+		sizeof(pad),
+		pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_docutel() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test Docutel PIN block format decoding
+	r = pinblock_decode_docutel(
+		pinblock,
+		sizeof(pinblock),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_docutel() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test Docutel PIN block format encoding using random padding
+	r = pinblock_encode_docutel(
+		pin2,
+		sizeof(pin2),
+		NULL,
+		0,
+		pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_docutel() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock_verify2, 3) != 0 ||
+		(pinblock[3] >> 4) != pinblock_verify2[3]
+	) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock_verify2", pinblock_verify2, sizeof(pinblock_verify2));
+		r = 1;
+		goto exit;
+	}
+
+	// Test Docutel PIN block format decoding with random padding
+	r = pinblock_decode_docutel(
+		pinblock,
+		sizeof(pinblock),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_docutel() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin2)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin2, sizeof(pin2)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin2", pin2, sizeof(pin2));
+		r = 1;
+		goto exit;
+	}
+
+	// Test PIN length validation
+	r = pinblock_encode_docutel(
+		pin2,
+		sizeof(pin2) + 1,
+		NULL,
+		0,
+		pinblock
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_encode_docutel() unexpectedly succeeded with 7 digit PIN\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test PIN digit validation
+	memcpy(pinblock, pinblock_verify, sizeof(pinblock_verify));
+	pinblock[1] |= 0xA0;
+	r = pinblock_decode_docutel(
+		pinblock,
+		sizeof(pinblock),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_docutel() unexpectedly succeeded with bad PIN block\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file pinblock_dual_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made examples
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t pan10[] = { 0x12, 0x34, 0x56, 0x78, 0x90 };
+static const uint8_t pan11[] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0x1F };
+static const uint8_t pan11_padded[] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0x1F, 0xFF };
+static const uint8_t pan12[] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0x12 };
+static const uint8_t pan13[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t pan16[] = { 0x41, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11 };
+static const uint8_t pan19[] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0x12, 0x34, 0x56, 0x78, 0x9F };
+static const uint8_t panfield11_verify[] = { 0x00, 0x12, 0x34, 0x56, 0x78, 0x90, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+static const uint8_t* const pans[] = { pan10, pan11, pan11_padded, pan12, pan13, pan16, pan19 };
+static const size_t pan_lens[] = { sizeof(pan10), sizeof(pan11), sizeof(pan11_padded), sizeof(pan12), sizeof(pan13), sizeof(pan16), sizeof(pan19) };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t pinfield[PINBLOCK128_SIZE];
+	uint8_t panfield[PINBLOCK128_SIZE];
+	uint8_t pinblock_verify[PINBLOCK_SIZE];
+	uint8_t panfield_verify[PINBLOCK128_SIZE];
+	const uint8_t* batch_pins[3] = { pin, pin, pin };
+	size_t batch_pin_lens[3] = { sizeof(pin), 3, sizeof(pin) };
+	uint8_t pinblocks[3 * PINBLOCK_SIZE];
+	uint8_t pinfields[3 * PINBLOCK128_SIZE];
+	uint8_t panfields[3 * PINBLOCK128_SIZE];
+	uint8_t zero[PINBLOCK128_SIZE] = { 0 };
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test dual encoding for various PAN lengths
+	for (size_t i = 0; i < sizeof(pans) / sizeof(pans[0]); ++i) {
+		r = pinblock_encode_iso9564_format0_format4(
+			pin,
+			sizeof(pin),
+			pans[i],
+			pan_lens[i],
+			pinblock,
+			pinfield,
+			panfield
+		);
+		if (r) {
+			fprintf(stderr, "pinblock_encode_iso9564_format0_format4() failed; r=%d\n", r);
+			goto exit;
+		}
+
+		r = pinblock_encode_iso9564_format0(pin, sizeof(pin), pans[i], pan_lens[i], pinblock_verify);
+		if (r) {
+			fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+			goto exit;
+		}
+		if (memcmp(pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+			fprintf(stderr, "Format 0 PIN block is incorrect\n");
+			print_buf("pinblock", pinblock, sizeof(pinblock));
+			print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+			r = 1;
+			goto exit;
+		}
+
+		r = pinblock_encode_iso9564_format4_panfield(pans[i], pan_lens[i], panfield_verify);
+		if (r) {
+			fprintf(stderr, "pinblock_encode_iso9564_format4_panfield() failed; r=%d\n", r);
+			goto exit;
+		}
+		if (memcmp(panfield, panfield_verify, sizeof(panfield_verify)) != 0) {
+			fprintf(stderr, "Format 4 PAN field is incorrect\n");
+			print_buf("panfield", panfield, sizeof(panfield));
+			print_buf("panfield_verify", panfield_verify, sizeof(panfield_verify));
+			r = 1;
+			goto exit;
+		}
+
+		r = pinblock_decode_iso9564_format4_pinfield(
+			pinfield,
+			sizeof(pinfield),
+			decoded_pin,
+			&decoded_pin_len
+		);
+		if (r) {
+			fprintf(stderr, "pinblock_decode_iso9564_format4_pinfield() failed; r=%d\n", r);
+			goto exit;
+		}
+		if (decoded_pin_len != sizeof(pin) ||
+			memcmp(decoded_pin, pin, sizeof(pin)) != 0
+		) {
+			fprintf(stderr, "Decoded PIN is incorrect\n");
+			print_buf("decoded_pin", decoded_pin, decoded_pin_len);
+			print_buf("pin", pin, sizeof(pin));
+			r = 1;
+			goto exit;
+		}
+	}
+
+	// Test PAN of less than 12 digits in PAN buffer with additional padding
+	r = pinblock_encode_iso9564_format0_format4(
+		pin,
+		sizeof(pin),
+		pan11_padded,
+		sizeof(pan11_padded),
+		pinblock,
+		pinfield,
+		panfield
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0_format4() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(panfield, panfield11_verify, sizeof(panfield11_verify)) != 0) {
+		fprintf(stderr, "Format 4 PAN field is incorrect\n");
+		print_buf("panfield", panfield, sizeof(panfield));
+		print_buf("panfield11_verify", panfield11_verify, sizeof(panfield11_verify));
+		r = 1;
+		goto exit;
+	}
+	r = pinblock_decode_iso9564_format0(
+		pinblock,
+		sizeof(pinblock),
+		pan11_padded,
+		sizeof(pan11_padded),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+
+	// Test batch dual encoding with one invalid PIN length
+	r = pinblock_encode_iso9564_format0_format4_batch(
+		batch_pins,
+		batch_pin_lens,
+		pans + 4,
+		pan_lens + 4,
+		3,
+		pinblocks,
+		pinfields,
+		panfields
+	);
+	if (r != 1) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0_format4_batch() failed; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), pan19, sizeof(pan19), pinblock_verify);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblocks + 2 * PINBLOCK_SIZE, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "Format 0 PIN block is incorrect\n");
+		print_buf("pinblock", pinblocks + 2 * PINBLOCK_SIZE, PINBLOCK_SIZE);
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(pinblocks + PINBLOCK_SIZE, zero, PINBLOCK_SIZE) != 0 ||
+		memcmp(pinfields + PINBLOCK128_SIZE, zero, PINBLOCK128_SIZE) != 0 ||
+		memcmp(panfields + PINBLOCK128_SIZE, zero, PINBLOCK128_SIZE) != 0
+	) {
+		fprintf(stderr, "Outputs for invalid PIN length were not cleared\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file pinblock_eci_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04 };
+static const uint8_t eci2_pinblock_verify[] = { 0x12, 0x34 }; // This is as much as we can directly compare
+
+// Hand made example
+static const uint8_t pin2[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t eci3_pinblock_verify[] = { 0x51, 0x23, 0x45 }; // This is as much as we can directly compare
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t pinblock2[PINBLOCK_SIZE];
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test ECI-2 PIN block format encoding
+	r = pinblock_encode_eci2(pin, sizeof(pin), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_eci2() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, eci2_pinblock_verify, sizeof(eci2_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("eci2_pinblock_verify", eci2_pinblock_verify, sizeof(eci2_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ECI-2 PIN block format encoding randomness
+	r = pinblock_encode_eci2(pin, sizeof(pin), pinblock2);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_eci2() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock2, PINBLOCK_SIZE) == 0) {
+		fprintf(stderr, "PIN blocks are not unique\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock2", pinblock2, sizeof(pinblock2));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ECI-2 PIN block format decoding
+	r = pinblock_decode_eci2(pinblock, sizeof(pinblock), decoded_pin, &decoded_pin_len);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_eci2() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ECI-2 PIN length validation
+	r = pinblock_encode_eci2(pin2, sizeof(pin2), pinblock);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_encode_eci2() unexpectedly succeeded with 5 digit PIN\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test ECI-3 PIN block format encoding
+	r = pinblock_encode_eci3(pin2, sizeof(pin2), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_eci3() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, eci3_pinblock_verify, sizeof(eci3_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("eci3_pinblock_verify", eci3_pinblock_verify, sizeof(eci3_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ECI-3 PIN block format decoding
+	r = pinblock_decode_eci3(pinblock, sizeof(pinblock), decoded_pin, &decoded_pin_len);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_eci3() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin2)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin2, sizeof(pin2)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin2", pin2, sizeof(pin2));
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
@@ -151,6 +151,26 @@ int main(void)
 		goto exit;
 	}
 
+	// Test validation of last padding digit
+	pinblock[6] ^= 1;
+	pinblock[7] ^= 1;
+	r = pinblock_decode_iso9564_format2(
+		pinblock,
+		sizeof(pinblock),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_iso9564_format2() unexpectedly succeeded with bad last padding digit\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
 	printf("All tests passed.\n");
 	r = 0;
 	goto exit;
@@ -0,0 +1,185 @@
+/**
+ * @file pinblock_ibm3624_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t pinblock_verify[] = { 0x12, 0x34, 0x5F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+// Hand made example
+static const uint8_t pin2[] = { 0x09, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00, 0x09, 0x08 };
+static const uint8_t pinblock_verify2[] = { 0x98, 0x76, 0x54, 0x32, 0x10, 0x98, 0xCC, 0xCC };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test IBM 3624 PIN block format encoding using Diebold/IBM ATM padding
+	r = pinblock_encode_ibm3624(
+		pin,
+		sizeof(pin),
+		0xF,
+		pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_ibm3624() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test IBM 3624 PIN block format decoding
+	r = pinblock_decode_ibm3624(
+		pinblock,
+		sizeof(pinblock),
+		0xF,
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_ibm3624() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test IBM 3624 PIN block format encoding using other pad digit
+	r = pinblock_encode_ibm3624(
+		pin2,
+		sizeof(pin2),
+		0xC,
+		pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_ibm3624() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock_verify2, sizeof(pinblock_verify2)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock_verify2", pinblock_verify2, sizeof(pinblock_verify2));
+		r = 1;
+		goto exit;
+	}
+
+	// Test IBM 3624 PIN block format decoding using other pad digit
+	r = pinblock_decode_ibm3624(
+		pinblock,
+		sizeof(pinblock),
+		0xC,
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_ibm3624() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin2)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin2, sizeof(pin2)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin2", pin2, sizeof(pin2));
+		r = 1;
+		goto exit;
+	}
+
+	// Test incorrect pad digit
+	r = pinblock_decode_ibm3624(
+		pinblock,
+		sizeof(pinblock),
+		0xF,
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_ibm3624() unexpectedly succeeded with bad pad digit\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test padding validation
+	pinblock[7] ^= 1;
+	r = pinblock_decode_ibm3624(
+		pinblock,
+		sizeof(pinblock),
+		0xC,
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_ibm3624() unexpectedly succeeded with bad PIN block\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file pinblock_mastercard_pnpl_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04 };
+static const uint8_t pan[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t pinblock_verify[] = { 0x24, 0x12, 0x74, 0xED, 0xCB, 0xA9, 0x87, 0x6F };
+
+// Incorrect test PAN
+static const uint8_t bad_pan[] = { 0x40, 0x88, 0x88, 0x88, 0x88, 0x88, 0x9F };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test Mastercard PNPL PIN block format encoding
+	r = pinblock_encode_mastercard_pnpl(
+		pin,
+		sizeof(pin),
+		pan,
+		sizeof(pan),
+		pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_mastercard_pnpl() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test Mastercard PNPL PIN block format decoding
+	r = pinblock_decode_mastercard_pnpl(
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_mastercard_pnpl() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test padding validation
+	r = pinblock_decode_mastercard_pnpl(
+		pinblock,
+		sizeof(pinblock),
+		bad_pan,
+		sizeof(bad_pan),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_mastercard_pnpl() unexpectedly succeeded with bad PAN\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file pinblock_rebind_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t old_pan[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t new_pan[] = { 0x54, 0x99, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33 };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t pinblock_verify[PINBLOCK_SIZE];
+	uint8_t pinblocks[3 * PINBLOCK_SIZE];
+	uint8_t pinblocks_verify[3 * PINBLOCK_SIZE];
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test ISO 9564-1:2017 PIN block format 0 rebinding
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), old_pan, sizeof(old_pan), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), new_pan, sizeof(new_pan), pinblock_verify);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_rebind_pan(
+		pinblock,
+		sizeof(pinblock),
+		old_pan,
+		sizeof(old_pan),
+		new_pan,
+		sizeof(new_pan)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_rebind_pan() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test ISO 9564-1:2017 PIN block format 3 rebinding
+	r = pinblock_encode_iso9564_format3(pin, sizeof(pin), old_pan, sizeof(old_pan), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format3() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_rebind_pan(
+		pinblock,
+		sizeof(pinblock),
+		old_pan,
+		sizeof(old_pan),
+		new_pan,
+		sizeof(new_pan)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_rebind_pan() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_decode_iso9564_format3(
+		pinblock,
+		sizeof(pinblock),
+		new_pan,
+		sizeof(new_pan),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_iso9564_format3() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test unsupported PIN block format
+	r = pinblock_encode_iso9564_format2(pin, sizeof(pin), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format2() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_rebind_pan(
+		pinblock,
+		sizeof(pinblock),
+		old_pan,
+		sizeof(old_pan),
+		new_pan,
+		sizeof(new_pan)
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_rebind_pan() unexpectedly succeeded with format 2 PIN block\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test batch rebinding with one unsupported PIN block format
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), old_pan, sizeof(old_pan), pinblocks);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format2(pin, sizeof(pin), pinblocks + PINBLOCK_SIZE);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format2() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), old_pan, sizeof(old_pan), pinblocks + 2 * PINBLOCK_SIZE);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	memcpy(pinblocks_verify, pinblock_verify, PINBLOCK_SIZE);
+	memcpy(pinblocks_verify + PINBLOCK_SIZE, pinblocks + PINBLOCK_SIZE, PINBLOCK_SIZE);
+	memcpy(pinblocks_verify + 2 * PINBLOCK_SIZE, pinblock_verify, PINBLOCK_SIZE);
+	r = pinblock_rebind_pan_batch(
+		pinblocks,
+		3,
+		old_pan,
+		sizeof(old_pan),
+		new_pan,
+		sizeof(new_pan)
+	);
+	if (r != 1) {
+		fprintf(stderr, "pinblock_rebind_pan_batch() failed; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(pinblocks, pinblocks_verify, sizeof(pinblocks_verify)) != 0) {
+		fprintf(stderr, "PIN blocks are incorrect\n");
+		print_buf("pinblocks", pinblocks, sizeof(pinblocks));
+		print_buf("pinblocks_verify", pinblocks_verify, sizeof(pinblocks_verify));
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
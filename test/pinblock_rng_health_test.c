@@ -0,0 +1,184 @@
+/**
+ * @file pinblock_rng_health_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made examples
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t pan[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t pinblock_format0[] = { 0x05, 0x12, 0x74, 0x5B, 0xA9, 0x87, 0x6F, 0x6F };
+static const uint8_t pinfield_stuck[] = {
+	0x45, 0x12, 0x34, 0x5A, 0xAA, 0xAA, 0xAA, 0xAA,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+static const uint8_t pinfield_biased[] = {
+	0x45, 0x12, 0x34, 0x5A, 0xAA, 0xAA, 0xAA, 0xAA,
+	0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+};
+
+int main(void)
+{
+	int r;
+	struct pinblock_rng_health_t health;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t pinfield[PINBLOCK128_SIZE];
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test healthy RNG
+	pinblock_rng_health_init(&health);
+	for (size_t i = 0; i < 100; ++i) {
+		r = pinblock_encode_iso9564_format3(pin, sizeof(pin), pan, sizeof(pan), pinblock);
+		if (r) {
+			fprintf(stderr, "pinblock_encode_iso9564_format3() failed; r=%d\n", r);
+			goto exit;
+		}
+		r = pinblock_rng_health_update(&health, pinblock, sizeof(pinblock), pan, sizeof(pan));
+		if (r) {
+			fprintf(stderr, "pinblock_rng_health_update() failed; r=%d\n", r);
+			goto exit;
+		}
+
+		r = pinblock_encode_iso9564_format4_pinfield(pin, sizeof(pin), pinfield);
+		if (r) {
+			fprintf(stderr, "pinblock_encode_iso9564_format4_pinfield() failed; r=%d\n", r);
+			goto exit;
+		}
+		r = pinblock_rng_health_update(&health, pinfield, sizeof(pinfield), NULL, 0);
+		if (r) {
+			fprintf(stderr, "pinblock_rng_health_update() failed; r=%d\n", r);
+			goto exit;
+		}
+	}
+	if (health.failures) {
+		fprintf(stderr, "RNG health tests unexpectedly failed; failures=0x%02X\n", health.failures);
+		r = 1;
+		goto exit;
+	}
+
+	// Test unsupported PIN block format
+	r = pinblock_rng_health_update(&health, pinblock_format0, sizeof(pinblock_format0), pan, sizeof(pan));
+	if (r <= 0) {
+		fprintf(stderr, "pinblock_rng_health_update() unexpectedly accepted format 0; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+
+	// Test stuck RNG
+	pinblock_rng_health_init(&health);
+	r = pinblock_rng_health_update(&health, pinfield_stuck, sizeof(pinfield_stuck), NULL, 0);
+	if (r) {
+		fprintf(stderr, "pinblock_rng_health_update() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (!(health.failures & PINBLOCK_RNG_HEALTH_RCT_FAILED)) {
+		fprintf(stderr, "Repetition count test did not detect stuck RNG; failures=0x%02X\n", health.failures);
+		r = 1;
+		goto exit;
+	}
+
+	// Test biased RNG that never repeats consecutively
+	pinblock_rng_health_init(&health);
+	for (size_t i = 0; i < 32; ++i) {
+		r = pinblock_rng_health_update(&health, pinfield_biased, sizeof(pinfield_biased), NULL, 0);
+		if (r) {
+			fprintf(stderr, "pinblock_rng_health_update() failed; r=%d\n", r);
+			goto exit;
+		}
+	}
+	if (health.failures != PINBLOCK_RNG_HEALTH_APT_FAILED) {
+		fprintf(stderr, "Adaptive proportion test did not detect biased RNG; failures=0x%02X\n", health.failures);
+		r = 1;
+		goto exit;
+	}
+
+	// Test format 3 decoding with RNG health monitor
+	pinblock_rng_health_init(&health);
+	r = pinblock_encode_iso9564_format3(pin, sizeof(pin), pan, sizeof(pan), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format3() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_rng_health_decode(&health, pinblock, sizeof(pinblock), pan, sizeof(pan), decoded_pin, &decoded_pin_len);
+	if (r) {
+		fprintf(stderr, "pinblock_rng_health_decode() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin) || memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (health.apt_window_count != 14 - sizeof(pin) || health.failures) {
+		fprintf(stderr, "RNG health monitor was not updated by decoding; apt_window_count=%u; failures=0x%02X\n", health.apt_window_count, health.failures);
+		r = 1;
+		goto exit;
+	}
+
+	// Test format 4 decoding with RNG health monitor and stuck RNG
+	r = pinblock_rng_health_decode(&health, pinfield_stuck, sizeof(pinfield_stuck), NULL, 0, decoded_pin, &decoded_pin_len);
+	if (r) {
+		fprintf(stderr, "pinblock_rng_health_decode() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin) || memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (!(health.failures & PINBLOCK_RNG_HEALTH_RCT_FAILED)) {
+		fprintf(stderr, "Repetition count test did not detect stuck RNG while decoding; failures=0x%02X\n", health.failures);
+		r = 1;
+		goto exit;
+	}
+
+	// Test decoding without RNG health monitor
+	r = pinblock_rng_health_decode(NULL, pinfield_biased, sizeof(pinfield_biased), NULL, 0, decoded_pin, &decoded_pin_len);
+	if (r) {
+		fprintf(stderr, "pinblock_rng_health_decode() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin) || memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test invalid PIN block
+	memcpy(pinblock, pinblock_format0, sizeof(pinblock));
+	r = pinblock_rng_health_decode(&health, pinblock, sizeof(pinblock), pan, sizeof(pan), decoded_pin, &decoded_pin_len);
+	if (r == 0 || decoded_pin_len != 0) {
+		fprintf(stderr, "pinblock_rng_health_decode() unexpectedly accepted format 0; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
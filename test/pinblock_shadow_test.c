@@ -0,0 +1,262 @@
+/**
+ * @file pinblock_shadow_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t pan[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t new_pan[] = { 0x54, 0x99, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33 };
+
+static void shadow_callback(const char* kernel, void* ctx)
+{
+	unsigned int* mismatch_count = ctx;
+
+	fprintf(stderr, "Shadow verification mismatch for %s()\n", kernel);
+	++*mismatch_count;
+}
+
+int main(void)
+{
+	int r;
+	unsigned int mismatch_count = 0;
+	struct pinblock_shadow_stats_t stats;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t converted_pinblock[PINBLOCK_SIZE];
+	uint8_t pinfield[PINBLOCK128_SIZE];
+	uint8_t panfield[PINBLOCK128_SIZE];
+	uint8_t pinblocks[4 * PINBLOCK_SIZE];
+	uint8_t rebind_pinblocks[2 * PINBLOCK_SIZE];
+	const uint8_t* pans[4] = { pan, pan, pan, pan };
+	size_t pan_lens[4] = { sizeof(pan), sizeof(pan), sizeof(pan), sizeof(pan) };
+	unsigned int format;
+	uint8_t pin_bcd[PINBLOCK_PIN_BCD_SIZE];
+
+	// Verify every result
+	r = pinblock_shadow_configure(1, 0, &shadow_callback, &mismatch_count);
+	if (r) {
+		fprintf(stderr, "pinblock_shadow_configure() failed; r=%d\n", r);
+		goto exit;
+	}
+
+	// Test shadow verification of combined format 0 and format 4 encoding
+	r = pinblock_encode_iso9564_format0_format4(
+		pin,
+		sizeof(pin),
+		pan,
+		sizeof(pan),
+		pinblock,
+		pinfield,
+		panfield
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0_format4() failed; r=%d\n", r);
+		goto exit;
+	}
+
+	// Test shadow verification of conversion
+	r = pinblock_convert(pinblock, sizeof(pinblock), pan, sizeof(pan), PINBLOCK_ISO9564_FORMAT_3, converted_pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_convert() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_convert(converted_pinblock, sizeof(converted_pinblock), NULL, 0, PINBLOCK_ISO9564_FORMAT_1, pinblock);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_convert() unexpectedly succeeded without PAN\n");
+		r = 1;
+		goto exit;
+	}
+	r = pinblock_convert(converted_pinblock, sizeof(converted_pinblock), pan, sizeof(pan), PINBLOCK_ISO9564_FORMAT_1, pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_convert() failed; r=%d\n", r);
+		goto exit;
+	}
+	converted_pinblock[1] ^= 0xF0;
+	r = pinblock_convert(converted_pinblock, sizeof(converted_pinblock), pan, sizeof(pan), PINBLOCK_ISO9564_FORMAT_2, pinblock);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_convert() unexpectedly succeeded with invalid PIN digit\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test shadow verification of in-place conversion
+	r = pinblock_convert(pinblock, sizeof(pinblock), pan, sizeof(pan), PINBLOCK_ISO9564_FORMAT_0, pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_convert() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), pan, sizeof(pan), converted_pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, converted_pinblock, sizeof(pinblock)) != 0) {
+		fprintf(stderr, "In-place converted PIN block is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test shadow verification of batch validation
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), pan, sizeof(pan), pinblocks);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format2(pin, sizeof(pin), pinblocks + PINBLOCK_SIZE);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format2() failed; r=%d\n", r);
+		goto exit;
+	}
+	memcpy(pinblocks + 2 * PINBLOCK_SIZE, pinblocks, PINBLOCK_SIZE);
+	pinblocks[2 * PINBLOCK_SIZE + 1] ^= 0xF0;
+	memcpy(pinblocks + 3 * PINBLOCK_SIZE, pinblocks, PINBLOCK_SIZE);
+	pinblocks[3 * PINBLOCK_SIZE] = 0x02;
+	r = pinblock_validate_batch(pinblocks, 4, pans, pan_lens, NULL, NULL);
+	if (r != 2) {
+		fprintf(stderr, "pinblock_validate_batch() failed; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+
+	// Test shadow verification of packed BCD decoding
+	r = pinblock_decode_bcd(pinblocks, PINBLOCK_SIZE, pan, sizeof(pan), &format, pin_bcd);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_decode_bcd(pinblocks + 2 * PINBLOCK_SIZE, PINBLOCK_SIZE, pan, sizeof(pan), &format, pin_bcd);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_bcd() unexpectedly succeeded with invalid PIN digit\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test shadow verification of packed BCD encoding
+	r = pinblock_decode_bcd(pinblocks, PINBLOCK_SIZE, pan, sizeof(pan), &format, pin_bcd);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_bcd(PINBLOCK_ISO9564_FORMAT_3, pin_bcd, pan, sizeof(pan), pinblock, sizeof(pinblock));
+	if (r) {
+		fprintf(stderr, "pinblock_encode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_bcd(PINBLOCK_ISO9564_FORMAT_4, pin_bcd, NULL, 0, pinfield, sizeof(pinfield));
+	if (r) {
+		fprintf(stderr, "pinblock_encode_bcd() failed; r=%d\n", r);
+		goto exit;
+	}
+
+	// Test shadow verification of PAN rebinding
+	memcpy(rebind_pinblocks, pinblock, PINBLOCK_SIZE);
+	memcpy(rebind_pinblocks + PINBLOCK_SIZE, pinblocks, PINBLOCK_SIZE);
+	r = pinblock_rebind_pan(pinblock, sizeof(pinblock), pan, sizeof(pan), new_pan, sizeof(new_pan));
+	if (r) {
+		fprintf(stderr, "pinblock_rebind_pan() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_rebind_pan_batch(rebind_pinblocks, 2, pan, sizeof(pan), new_pan, sizeof(new_pan));
+	if (r) {
+		fprintf(stderr, "pinblock_rebind_pan_batch() failed; r=%d\n", r);
+		goto exit;
+	}
+
+	// Validate shadow verification statistics
+	pinblock_shadow_get_stats(&stats);
+	if (stats.verified != 17 || stats.mismatched != 0 || mismatch_count != 0) {
+		fprintf(stderr, "Shadow verification statistics are incorrect; verified=%lu; mismatched=%lu\n", stats.verified, stats.mismatched);
+		r = 1;
+		goto exit;
+	}
+
+	// Test sampling interval
+	r = pinblock_shadow_configure(2, 0, NULL, NULL);
+	if (r) {
+		fprintf(stderr, "pinblock_shadow_configure() failed; r=%d\n", r);
+		goto exit;
+	}
+	for (size_t i = 0; i < 10; ++i) {
+		r = pinblock_validate_batch(pinblocks, 1, pans, pan_lens, NULL, NULL);
+		if (r) {
+			fprintf(stderr, "pinblock_validate_batch() failed; r=%d\n", r);
+			goto exit;
+		}
+	}
+	pinblock_shadow_get_stats(&stats);
+	if (stats.verified != 5 || stats.mismatched != 0) {
+		fprintf(stderr, "Shadow verification statistics are incorrect; verified=%lu; mismatched=%lu\n", stats.verified, stats.mismatched);
+		r = 1;
+		goto exit;
+	}
+
+	// Test rate limit
+	r = pinblock_shadow_configure(1, 3, NULL, NULL);
+	if (r) {
+		fprintf(stderr, "pinblock_shadow_configure() failed; r=%d\n", r);
+		goto exit;
+	}
+	for (size_t i = 0; i < 10; ++i) {
+		r = pinblock_validate_batch(pinblocks, 1, pans, pan_lens, NULL, NULL);
+		if (r) {
+			fprintf(stderr, "pinblock_validate_batch() failed; r=%d\n", r);
+			goto exit;
+		}
+	}
+	pinblock_shadow_get_stats(&stats);
+	// Allow for the calls to straddle a second boundary
+	if (stats.verified < 3 || stats.verified > 6 ||
+		stats.verified + stats.rate_limited != 10
+	) {
+		fprintf(stderr, "Shadow verification statistics are incorrect; verified=%lu; rate_limited=%lu\n", stats.verified, stats.rate_limited);
+		r = 1;
+		goto exit;
+	}
+
+	// Test disabled shadow verification
+	r = pinblock_shadow_configure(0, 0, NULL, NULL);
+	if (r) {
+		fprintf(stderr, "pinblock_shadow_configure() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_validate_batch(pinblocks, 1, pans, pan_lens, NULL, NULL);
+	if (r) {
+		fprintf(stderr, "pinblock_validate_batch() failed; r=%d\n", r);
+		goto exit;
+	}
+	pinblock_shadow_get_stats(&stats);
+	if (stats.verified != 0) {
+		fprintf(stderr, "Shadow verification unexpectedly verified a result\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file pinblock_strict_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t nonce[] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0 };
+static const uint8_t wrong_nonce[] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF1 };
+
+// Number of accepted PIN fields out of 2^64
+static const uint64_t false_acceptance_format0 = 1111111110000ULL;
+static const uint64_t false_acceptance_format1 = 28893643407360000ULL;
+static const uint64_t false_acceptance_format3 = 89093007360000ULL;
+static const uint64_t false_acceptance_format0_pin_len5 = 100000ULL;
+
+int main(void)
+{
+	int r;
+	uint64_t false_acceptance;
+	struct pinblock_decode_strictness_t strictness;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	unsigned int format;
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test false acceptance without additional checks
+	r = pinblock_get_false_acceptance(PINBLOCK_ISO9564_FORMAT_0, NULL, &false_acceptance);
+	if (r || false_acceptance != false_acceptance_format0) {
+		fprintf(stderr, "Format 0 false acceptance is incorrect; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	r = pinblock_get_false_acceptance(PINBLOCK_ISO9564_FORMAT_1, NULL, &false_acceptance);
+	if (r || false_acceptance != false_acceptance_format1) {
+		fprintf(stderr, "Format 1 false acceptance is incorrect; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	r = pinblock_get_false_acceptance(PINBLOCK_ISO9564_FORMAT_2, NULL, &false_acceptance);
+	if (r || false_acceptance != false_acceptance_format0) {
+		fprintf(stderr, "Format 2 false acceptance is incorrect; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	r = pinblock_get_false_acceptance(PINBLOCK_ISO9564_FORMAT_3, NULL, &false_acceptance);
+	if (r || false_acceptance != false_acceptance_format3) {
+		fprintf(stderr, "Format 3 false acceptance is incorrect; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	r = pinblock_get_false_acceptance(PINBLOCK_ISO9564_FORMAT_4, NULL, &false_acceptance);
+	if (r || false_acceptance != false_acceptance_format0) {
+		fprintf(stderr, "Format 4 false acceptance is incorrect; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+
+	// Test false acceptance with additional checks
+	memset(&strictness, 0, sizeof(strictness));
+	strictness.nonce = nonce;
+	strictness.nonce_len = sizeof(nonce);
+	r = pinblock_get_false_acceptance(PINBLOCK_ISO9564_FORMAT_1, &strictness, &false_acceptance);
+	if (r || false_acceptance != false_acceptance_format0) {
+		fprintf(stderr, "Format 1 false acceptance with nonce is incorrect; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	memset(&strictness, 0, sizeof(strictness));
+	strictness.pin_len = sizeof(pin);
+	r = pinblock_get_false_acceptance(PINBLOCK_ISO9564_FORMAT_0, &strictness, &false_acceptance);
+	if (r || false_acceptance != false_acceptance_format0_pin_len5) {
+		fprintf(stderr, "Format 0 false acceptance with PIN length is incorrect; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+
+	// Test strict decoding with expected nonce
+	r = pinblock_encode_iso9564_format1(pin, sizeof(pin), nonce, sizeof(nonce), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format1() failed; r=%d\n", r);
+		goto exit;
+	}
+	memset(&strictness, 0, sizeof(strictness));
+	strictness.nonce = nonce;
+	strictness.nonce_len = sizeof(nonce);
+	r = pinblock_decode_strict(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		&strictness,
+		&format,
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_strict() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (format != PINBLOCK_ISO9564_FORMAT_1 ||
+		decoded_pin_len != sizeof(pin) ||
+		memcmp(decoded_pin, pin, sizeof(pin)) != 0
+	) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test strict decoding with incorrect nonce
+	strictness.nonce = wrong_nonce;
+	strictness.nonce_len = sizeof(wrong_nonce);
+	r = pinblock_decode_strict(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		&strictness,
+		&format,
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_strict() unexpectedly succeeded with incorrect nonce\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test strict decoding with incorrect PIN length
+	memset(&strictness, 0, sizeof(strictness));
+	strictness.pin_len = 4;
+	r = pinblock_decode_strict(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		&strictness,
+		&format,
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_strict() unexpectedly succeeded with incorrect PIN length\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test strict decoding without additional checks
+	r = pinblock_decode_strict(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		NULL,
+		&format,
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_strict() failed; r=%d\n", r);
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
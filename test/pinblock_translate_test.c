@@ -0,0 +1,311 @@
+/**
+ * @file pinblock_translate_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04 };
+static const uint8_t pan[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t ibm3624_pinblock[] = { 0x12, 0x34, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static const uint8_t ibm4704_pinblock[] = { 0x14, 0x12, 0x34, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static const uint8_t visa2_pinblock[] = { 0x41, 0x23, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00 };
+static const uint8_t docutel_pinblock[] = { 0x41, 0x23, 0x40, 0x12, 0x34, 0x56, 0x78, 0x9A };
+static const uint8_t format0_pinblock_verify[] = { 0x04, 0x12, 0x74, 0xED, 0xCB, 0xA9, 0x87, 0x6F };
+static const uint8_t format2_pinblock_verify[] = { 0x24, 0x12, 0x34, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t pinfield[PINBLOCK128_SIZE];
+	uint8_t src_pinblocks[PINBLOCK_SIZE * 3];
+	uint8_t pinblocks[PINBLOCK_SIZE * 3];
+	const uint8_t* pans[3] = { pan, pan, pan };
+	size_t pan_lens[3] = { sizeof(pan), sizeof(pan), sizeof(pan) };
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test IBM 3624 to ISO 9564-1:2017 format 0 translation
+	r = pinblock_translate_to_iso9564(
+		PINBLOCK_IBM3624,
+		ibm3624_pinblock,
+		sizeof(ibm3624_pinblock),
+		0xF,
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_0,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_translate_to_iso9564() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, format0_pinblock_verify, sizeof(format0_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("format0_pinblock_verify", format0_pinblock_verify, sizeof(format0_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test Docutel to ISO 9564-1:2017 format 2 translation
+	r = pinblock_translate_to_iso9564(
+		PINBLOCK_DOCUTEL,
+		docutel_pinblock,
+		sizeof(docutel_pinblock),
+		0,
+		NULL,
+		0,
+		PINBLOCK_ISO9564_FORMAT_2,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_translate_to_iso9564() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, format2_pinblock_verify, sizeof(format2_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("format2_pinblock_verify", format2_pinblock_verify, sizeof(format2_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-2 to ISO 9564-1:2017 format 2 translation
+	r = pinblock_translate_to_iso9564(
+		PINBLOCK_VISA2,
+		visa2_pinblock,
+		sizeof(visa2_pinblock),
+		0x0,
+		NULL,
+		0,
+		PINBLOCK_ISO9564_FORMAT_2,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_translate_to_iso9564() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, format2_pinblock_verify, sizeof(format2_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("format2_pinblock_verify", format2_pinblock_verify, sizeof(format2_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-4 to ISO 9564-1:2017 format 0 translation
+	r = pinblock_encode_visa4(
+		pin,
+		sizeof(pin),
+		pan,
+		sizeof(pan),
+		src_pinblocks
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_visa4() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_translate_to_iso9564(
+		PINBLOCK_VISA4,
+		src_pinblocks,
+		PINBLOCK_SIZE,
+		0,
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_0,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_translate_to_iso9564() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, format0_pinblock_verify, sizeof(format0_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("format0_pinblock_verify", format0_pinblock_verify, sizeof(format0_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test missing PAN for PAN bound source PIN block format
+	r = pinblock_translate_to_iso9564(
+		PINBLOCK_VISA4,
+		src_pinblocks,
+		PINBLOCK_SIZE,
+		0,
+		NULL,
+		0,
+		PINBLOCK_ISO9564_FORMAT_2,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_translate_to_iso9564() unexpectedly succeeded without PAN\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test IBM 4704 to ISO 9564-1:2017 format 4 translation
+	r = pinblock_translate_to_iso9564(
+		PINBLOCK_IBM4704,
+		ibm4704_pinblock,
+		sizeof(ibm4704_pinblock),
+		0,
+		NULL,
+		0,
+		PINBLOCK_ISO9564_FORMAT_4,
+		pinfield,
+		sizeof(pinfield)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_translate_to_iso9564() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_decode_iso9564_format4_pinfield(
+		pinfield,
+		sizeof(pinfield),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_iso9564_format4_pinfield() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin) ||
+		memcmp(decoded_pin, pin, sizeof(pin)) != 0
+	) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, decoded_pin_len);
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test missing PAN for PAN bound output PIN block format
+	r = pinblock_translate_to_iso9564(
+		PINBLOCK_IBM4704,
+		ibm4704_pinblock,
+		sizeof(ibm4704_pinblock),
+		0,
+		NULL,
+		0,
+		PINBLOCK_ISO9564_FORMAT_3,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_translate_to_iso9564() unexpectedly succeeded without PAN\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test invalid source PIN block
+	r = pinblock_translate_to_iso9564(
+		PINBLOCK_IBM4704,
+		docutel_pinblock,
+		sizeof(docutel_pinblock),
+		0,
+		NULL,
+		0,
+		PINBLOCK_ISO9564_FORMAT_2,
+		pinblock,
+		sizeof(pinblock)
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_translate_to_iso9564() unexpectedly succeeded with bad PIN block\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test batch translation with one invalid PIN block
+	memcpy(src_pinblocks, ibm4704_pinblock, PINBLOCK_SIZE);
+	memcpy(src_pinblocks + PINBLOCK_SIZE, docutel_pinblock, PINBLOCK_SIZE);
+	memcpy(src_pinblocks + PINBLOCK_SIZE * 2, ibm4704_pinblock, PINBLOCK_SIZE);
+	r = pinblock_translate_to_iso9564_batch(
+		PINBLOCK_IBM4704,
+		src_pinblocks,
+		3,
+		0,
+		pans,
+		pan_lens,
+		PINBLOCK_ISO9564_FORMAT_0,
+		pinblocks
+	);
+	if (r != 1) {
+		fprintf(stderr, "pinblock_translate_to_iso9564_batch() returned %d instead of 1\n", r);
+		r = 1;
+		goto exit;
+	}
+	for (size_t i = 0; i < 3; ++i) {
+		static const uint8_t zero[PINBLOCK_SIZE] = { 0 };
+		const uint8_t* verify = i == 1 ? zero : format0_pinblock_verify;
+
+		if (memcmp(pinblocks + (i * PINBLOCK_SIZE), verify, PINBLOCK_SIZE) != 0) {
+			fprintf(stderr, "PIN block %zu is incorrect\n", i);
+			print_buf("pinblock", pinblocks + (i * PINBLOCK_SIZE), PINBLOCK_SIZE);
+			print_buf("verify", verify, PINBLOCK_SIZE);
+			r = 1;
+			goto exit;
+		}
+	}
+
+	// Test unsupported source PIN block format
+	r = pinblock_translate_to_iso9564_batch(
+		PINBLOCK_PROPRIETARY_FORMAT_COUNT,
+		src_pinblocks,
+		3,
+		0,
+		pans,
+		pan_lens,
+		PINBLOCK_ISO9564_FORMAT_0,
+		pinblocks
+	);
+	if (r >= 0) {
+		fprintf(stderr, "pinblock_translate_to_iso9564_batch() unexpectedly succeeded with unsupported format\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
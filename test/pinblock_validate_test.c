@@ -0,0 +1,143 @@
+/**
+ * @file pinblock_validate_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t pan[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t validity_verify[] = { 0x0F, 0x00 };
+static const size_t histogram_verify[PINBLOCK_VALIDATION_RESULT_COUNT] = { 4, 1, 1, 1, 1, 1 };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblocks[9 * PINBLOCK_SIZE];
+	const uint8_t* pans[9] = { pan, pan, pan, pan, pan, pan, pan, NULL, pan };
+	size_t pan_lens[9] = { sizeof(pan), sizeof(pan), sizeof(pan), sizeof(pan), sizeof(pan), sizeof(pan), sizeof(pan), 0, sizeof(pan) };
+	uint8_t validity[2];
+	size_t histogram[PINBLOCK_VALIDATION_RESULT_COUNT] = { 0 };
+
+	// Valid PIN blocks
+	r = pinblock_encode_iso9564_format0(pin, sizeof(pin), pan, sizeof(pan), pinblocks);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format1(pin, sizeof(pin), NULL, 0, pinblocks + 1 * PINBLOCK_SIZE);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format1() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format2(pin, sizeof(pin), pinblocks + 2 * PINBLOCK_SIZE);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format2() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_encode_iso9564_format3(pin, sizeof(pin), pan, sizeof(pan), pinblocks + 3 * PINBLOCK_SIZE);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format3() failed; r=%d\n", r);
+		goto exit;
+	}
+
+	// Unsupported PIN block format
+	memset(pinblocks + 4 * PINBLOCK_SIZE, 0xCC, PINBLOCK_SIZE);
+
+	// Invalid PIN length
+	memcpy(pinblocks + 5 * PINBLOCK_SIZE, pinblocks, PINBLOCK_SIZE);
+	pinblocks[5 * PINBLOCK_SIZE] = 0x02;
+
+	// Invalid PIN digit
+	memcpy(pinblocks + 6 * PINBLOCK_SIZE, pinblocks, PINBLOCK_SIZE);
+	pinblocks[6 * PINBLOCK_SIZE + 1] ^= 0xF0;
+
+	// Missing PAN
+	memcpy(pinblocks + 7 * PINBLOCK_SIZE, pinblocks + 3 * PINBLOCK_SIZE, PINBLOCK_SIZE);
+
+	// Invalid padding digit
+	memcpy(pinblocks + 8 * PINBLOCK_SIZE, pinblocks + 2 * PINBLOCK_SIZE, PINBLOCK_SIZE);
+	pinblocks[9 * PINBLOCK_SIZE - 1] ^= 0x01;
+
+	// Test batch validation
+	r = pinblock_validate_batch(
+		pinblocks,
+		9,
+		pans,
+		pan_lens,
+		validity,
+		histogram
+	);
+	if (r != 5) {
+		fprintf(stderr, "pinblock_validate_batch() failed; r=%d\n", r);
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(validity, validity_verify, sizeof(validity_verify)) != 0) {
+		fprintf(stderr, "Validity bitmap is incorrect\n");
+		print_buf("validity", validity, sizeof(validity));
+		print_buf("validity_verify", validity_verify, sizeof(validity_verify));
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(histogram, histogram_verify, sizeof(histogram_verify)) != 0) {
+		fprintf(stderr, "Validation histogram is incorrect\n");
+		for (size_t i = 0; i < PINBLOCK_VALIDATION_RESULT_COUNT; ++i) {
+			fprintf(stderr, "histogram[%zu]=%zu\n", i, histogram[i]);
+		}
+		r = 1;
+		goto exit;
+	}
+
+	// Test batch validation of valid PIN blocks without bitmap and histogram
+	r = pinblock_validate_batch(
+		pinblocks,
+		4,
+		pans,
+		pan_lens,
+		NULL,
+		NULL
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_validate_batch() failed; r=%d\n", r);
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file pinblock_visa_pin_change_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t new_pin[] = { 0x01, 0x02, 0x03, 0x04 };
+static const uint8_t old_pin[] = { 0x05, 0x06, 0x07, 0x08 };
+static const uint8_t pan[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t pinblock_verify[] = { 0x52, 0x6A, 0x74, 0xED, 0xCB, 0xA9, 0x87, 0x6F };
+static const uint8_t new_pin_only_pinblock_verify[] = { 0x04, 0x12, 0x74, 0xED, 0xCB, 0xA9, 0x87, 0x6F };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t old_pinblock[PINBLOCK_SIZE];
+	uint8_t translated_pinblock[PINBLOCK_SIZE];
+	uint8_t translated_pinfield[PINBLOCK128_SIZE];
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test Visa new PIN only encoding
+	r = pinblock_encode_visa_pin_change(
+		new_pin,
+		sizeof(new_pin),
+		NULL,
+		0,
+		pan,
+		sizeof(pan),
+		pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_visa_pin_change() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, new_pin_only_pinblock_verify, sizeof(new_pin_only_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("new_pin_only_pinblock_verify", new_pin_only_pinblock_verify, sizeof(new_pin_only_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test Visa new and old PIN encoding
+	r = pinblock_encode_visa_pin_change(
+		new_pin,
+		sizeof(new_pin),
+		old_pin,
+		sizeof(old_pin),
+		pan,
+		sizeof(pan),
+		pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_visa_pin_change() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, pinblock_verify, sizeof(pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("pinblock_verify", pinblock_verify, sizeof(pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test Visa new and old PIN decoding
+	r = pinblock_decode_visa_pin_change(
+		pinblock,
+		sizeof(pinblock),
+		old_pin,
+		sizeof(old_pin),
+		pan,
+		sizeof(pan),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_visa_pin_change() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(new_pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, new_pin, sizeof(new_pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("new_pin", new_pin, sizeof(new_pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test Visa new and old PIN decoding without old PIN
+	r = pinblock_decode_visa_pin_change(
+		pinblock,
+		sizeof(pinblock),
+		NULL,
+		0,
+		pan,
+		sizeof(pan),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_visa_pin_change() unexpectedly succeeded without old PIN\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test translation to ISO 9564-1:2017 PIN block format 0
+	r = pinblock_encode_iso9564_format0(
+		old_pin,
+		sizeof(old_pin),
+		pan,
+		sizeof(pan),
+		old_pinblock
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_iso9564_format0() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_translate_visa_pin_change(
+		old_pinblock,
+		sizeof(old_pinblock),
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_0,
+		translated_pinblock,
+		sizeof(translated_pinblock)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_translate_visa_pin_change() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(translated_pinblock, new_pin_only_pinblock_verify, sizeof(new_pin_only_pinblock_verify)) != 0) {
+		fprintf(stderr, "Translated PIN block is incorrect\n");
+		print_buf("translated_pinblock", translated_pinblock, sizeof(translated_pinblock));
+		print_buf("new_pin_only_pinblock_verify", new_pin_only_pinblock_verify, sizeof(new_pin_only_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test translation to ISO 9564-1:2017 PIN block format 4
+	r = pinblock_translate_visa_pin_change(
+		old_pinblock,
+		sizeof(old_pinblock),
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_4,
+		translated_pinfield,
+		sizeof(translated_pinfield)
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_translate_visa_pin_change() failed; r=%d\n", r);
+		goto exit;
+	}
+	r = pinblock_decode_iso9564_format4_pinfield(
+		translated_pinfield,
+		sizeof(translated_pinfield),
+		decoded_pin,
+		&decoded_pin_len
+	);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_iso9564_format4_pinfield() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(new_pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, new_pin, sizeof(new_pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("new_pin", new_pin, sizeof(new_pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test translation with incorrect old PIN block
+	old_pinblock[6] ^= 1;
+	r = pinblock_translate_visa_pin_change(
+		old_pinblock,
+		sizeof(old_pinblock),
+		pinblock,
+		sizeof(pinblock),
+		pan,
+		sizeof(pan),
+		PINBLOCK_ISO9564_FORMAT_0,
+		translated_pinblock,
+		sizeof(translated_pinblock)
+	);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_translate_visa_pin_change() unexpectedly succeeded with bad old PIN block\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file pinblock_visa_test.c
+ *
+ * Copyright 2022 Leon Lynch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pinblock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hand made example
+static const uint8_t pin[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+static const uint8_t visa2_pinblock_verify[] = { 0x51, 0x23, 0x45, 0x00, 0x00, 0x00, 0x00, 0x00 };
+static const uint8_t visa3_pinblock_verify[] = { 0x12, 0x34, 0x5F, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+// Hand made example
+static const uint8_t pin2[] = { 0x01, 0x02, 0x03, 0x04 };
+static const uint8_t pan2[] = { 0x40, 0x12, 0x34, 0x56, 0x78, 0x90, 0x9F };
+static const uint8_t visa4_pinblock_verify[] = { 0x12, 0x34, 0xBF, 0xED, 0xCB, 0xA9, 0x87, 0x6F };
+
+// Incorrect test PAN
+static const uint8_t bad_pan[] = { 0x40, 0x88, 0x88, 0x88, 0x88, 0x88, 0x9F };
+
+static void print_buf(const char* buf_name, const void* buf, size_t length)
+{
+	const uint8_t* ptr = buf;
+	printf("%s: ", buf_name);
+	for (size_t i = 0; i < length; i++) {
+		printf("%02X", ptr[i]);
+	}
+	printf("\n");
+}
+
+int main(void)
+{
+	int r;
+	uint8_t pinblock[PINBLOCK_SIZE];
+	uint8_t decoded_pin[12];
+	size_t decoded_pin_len = 0;
+
+	// Test VISA-2 PIN block format encoding
+	r = pinblock_encode_visa2(pin, sizeof(pin), 0x0, pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_visa2() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, visa2_pinblock_verify, sizeof(visa2_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("visa2_pinblock_verify", visa2_pinblock_verify, sizeof(visa2_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-2 PIN block format decoding
+	r = pinblock_decode_visa2(pinblock, sizeof(pinblock), 0x0, decoded_pin, &decoded_pin_len);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_visa2() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-2 padding validation
+	r = pinblock_decode_visa2(pinblock, sizeof(pinblock), 0x9, decoded_pin, &decoded_pin_len);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_visa2() unexpectedly succeeded with bad pad digit\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-3 PIN block format encoding
+	r = pinblock_encode_visa3(pin, sizeof(pin), 0x0, pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_visa3() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, visa3_pinblock_verify, sizeof(visa3_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("visa3_pinblock_verify", visa3_pinblock_verify, sizeof(visa3_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-3 PIN block format decoding
+	r = pinblock_decode_visa3(pinblock, sizeof(pinblock), 0x0, decoded_pin, &decoded_pin_len);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_visa3() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin, sizeof(pin)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin", pin, sizeof(pin));
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-3 padding validation
+	pinblock[7] ^= 1;
+	r = pinblock_decode_visa3(pinblock, sizeof(pinblock), 0x0, decoded_pin, &decoded_pin_len);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_visa3() unexpectedly succeeded with bad PIN block\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-4 PIN block format encoding
+	r = pinblock_encode_visa4(pin2, sizeof(pin2), pan2, sizeof(pan2), pinblock);
+	if (r) {
+		fprintf(stderr, "pinblock_encode_visa4() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (memcmp(pinblock, visa4_pinblock_verify, sizeof(visa4_pinblock_verify)) != 0) {
+		fprintf(stderr, "PIN block is incorrect\n");
+		print_buf("pinblock", pinblock, sizeof(pinblock));
+		print_buf("visa4_pinblock_verify", visa4_pinblock_verify, sizeof(visa4_pinblock_verify));
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-4 PIN block format decoding
+	r = pinblock_decode_visa4(pinblock, sizeof(pinblock), pan2, sizeof(pan2), decoded_pin, &decoded_pin_len);
+	if (r) {
+		fprintf(stderr, "pinblock_decode_visa4() failed; r=%d\n", r);
+		goto exit;
+	}
+	if (decoded_pin_len != sizeof(pin2)) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+	if (memcmp(decoded_pin, pin2, sizeof(pin2)) != 0) {
+		fprintf(stderr, "Decoded PIN is incorrect\n");
+		print_buf("decoded_pin", decoded_pin, sizeof(decoded_pin));
+		print_buf("pin2", pin2, sizeof(pin2));
+		r = 1;
+		goto exit;
+	}
+
+	// Test VISA-4 PAN validation
+	r = pinblock_decode_visa4(pinblock, sizeof(pinblock), bad_pan, sizeof(bad_pan), decoded_pin, &decoded_pin_len);
+	if (r == 0) {
+		fprintf(stderr, "pinblock_decode_visa4() unexpectedly succeeded with bad PAN\n");
+		r = 1;
+		goto exit;
+	}
+	if (decoded_pin_len != 0) {
+		fprintf(stderr, "Decoded PIN length is incorrect\n");
+		r = 1;
+		goto exit;
+	}
+
+	printf("All tests passed.\n");
+	r = 0;
+	goto exit;
+
+exit:
+	return r;
+}